@@ -0,0 +1,118 @@
+// microbenchmarks dos kernels de simd_kernels.h: mede cada kernel em cada nível suportado e compara o resultado com
+// a implementação escalar. Uso: kernel_bench [repetições]
+
+#include "../utils/simd_kernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+template<typename T>
+const char* typeName() {
+    if (std::is_same<T, double>::value) return "double";
+    if (std::is_same<T, float>::value) return "float";
+    return "int32";
+}
+
+template<typename T>
+std::vector<T> randomRow(int n, std::mt19937& rng) {
+    std::vector<T> row(n);
+    std::uniform_int_distribution<int> value(0, 1000000);
+    for (T& x : row) x = (T)value(rng);
+    return row;
+}
+
+// o argmin corre sobre uma linha com uma fração crescente de posições marcadas, como no vizinho mais próximo
+template<typename T>
+double benchArgmin(int n, int repetitions, std::vector<int>& answers) {
+    std::mt19937 rng(n);
+    std::vector<T> row = randomRow<T>(n, rng);
+    std::vector<uint64_t> masked = makeBitmask(n);
+    std::vector<int> order(n);
+    for (int i = 0; i < n; i++) order[i] = i;
+    std::shuffle(order.begin(), order.end(), rng);
+
+    answers.clear();
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; r++) {
+        std::fill(masked.begin(), masked.end(), 0);
+        for (int step = 0; step < n; step += std::max(1, n / 64)) {
+            for (int i = step; i < std::min(n, step + std::max(1, n / 64)); i++) setBit(masked, order[i]);
+            int best = maskedArgmin(row.data(), masked.data(), n);
+            if (r == 0) answers.push_back(best);
+        }
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Prim denso completo sobre uma matriz aleatória n*n
+template<typename T>
+double benchPrim(int n, int repetitions, std::vector<int>& answers) {
+    std::mt19937 rng(n + 1);
+    std::vector<T> matrix = randomRow<T>(n * n, rng);
+    std::vector<T> key(n);
+    std::vector<int> parent(n);
+    std::vector<uint64_t> in_tree = makeBitmask(n);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; r++) {
+        std::fill(key.begin(), key.end(), std::numeric_limits<T>::max());
+        std::fill(parent.begin(), parent.end(), -1);
+        std::fill(in_tree.begin(), in_tree.end(), 0);
+        key[0] = 0;
+        for (int added = 0; added < n; added++) {
+            int u = maskedArgmin(key.data(), in_tree.data(), n);
+            setBit(in_tree, u);
+            relaxKeys(&matrix[(size_t)u * n], in_tree.data(), key.data(), parent.data(), u, n);
+        }
+    }
+    answers = parent;
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename T, typename Bench>
+bool runKernel(const char* kernel, Bench bench, int n, int repetitions, SimdLevel detected) {
+    setSimdLevel(SimdLevel::Scalar);
+    std::vector<int> expected;
+    double scalar_time = bench(n, repetitions, expected);
+    bool ok = true;
+    for (int level = (int)SimdLevel::Scalar; level <= (int)detected; level++) {
+        setSimdLevel((SimdLevel)level);
+        std::vector<int> answers;
+        double time = level == 0 ? scalar_time : bench(n, repetitions, answers);
+        bool same = level == 0 || answers == expected;
+        ok &= same;
+        printf("%-14s %-7s n=%-6d %-8s %10.3f ms  x%5.2f  %s\n", kernel, typeName<T>(), n, simdLevelName((SimdLevel)level),
+               time * 1000.0 / repetitions, scalar_time / time, same ? "ok" : "MISMATCH");
+    }
+    return ok;
+}
+
+}
+
+int main(int argc, char** argv) {
+    int repetitions = argc > 1 ? std::max(1, atoi(argv[1])) : 5;
+    SimdLevel detected = detectedSimdLevel();
+    printf("detected: %s\n", simdLevelName(detected));
+
+    bool ok = true;
+    for (int n : {100, 1000, 5000}) {
+        ok &= runKernel<double>("maskedArgmin", benchArgmin<double>, n, repetitions * 20, detected);
+        ok &= runKernel<float>("maskedArgmin", benchArgmin<float>, n, repetitions * 20, detected);
+        ok &= runKernel<int32_t>("maskedArgmin", benchArgmin<int32_t>, n, repetitions * 20, detected);
+    }
+    for (int n : {100, 1000, 3000}) {
+        ok &= runKernel<double>("prim", benchPrim<double>, n, repetitions, detected);
+        ok &= runKernel<float>("prim", benchPrim<float>, n, repetitions, detected);
+        ok &= runKernel<int32_t>("prim", benchPrim<int32_t>, n, repetitions, detected);
+    }
+    setSimdLevel(detected);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,303 @@
+#include "utils/graph.h"
+
+#include <thread>
+#include <random>
+
+/// @brief Resolve um cluster com as heurísticas sobre matriz do grafo: vizinho mais próximo a partir do vértice 0
+/// (Graph::nearestNeighbourOnMatrix) melhorado com 2-opt (Graph::twoOptOnMatrix).
+/// Esta função tem complexidade O(m^2 log k) mais o custo dos movimentos 2-opt, onde m é o tamanho da matriz.
+/// @param dist Matriz de distâncias local (row-major, m*m).
+/// @param m Número de vértices locais.
+/// @return Ciclo com índices locais 0..m-1.
+static std::vector<int> solveLocal(const std::vector<double>& dist, int m) {
+    std::vector<int> tour = Graph::nearestNeighbourOnMatrix(dist, m, 0);
+    Graph::twoOptOnMatrix(tour, dist, CLUSTER_NEIGHBOURS, 0.0);
+    return tour;
+}
+
+/// @brief Verifica se os vértices do grafo têm coordenadas.
+/// Esta função tem complexidade O(V).
+/// @return True se algum vértice tiver latitude ou longitude diferente de 0.
+bool Graph::hasCoordinates() const {
+    for (auto& vertex : vertices) {
+        if (vertex.second.lat != 0.0 || vertex.second.longi != 0.0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief Divide os vértices em clusters espacialmente coerentes.
+/// Com coordenadas é usado k-means (inicialização k-means++ com semente fixa, atribuição paralela).
+/// Sem coordenadas, é calculada a MST e cortadas as num_clusters - 1 arestas mais pesadas; cada árvore com mais de
+/// CLUSTER_MAX_FACTOR vezes o tamanho médio pretendido é dividida em troços consecutivos da sua pré-ordem.
+/// Esta função tem complexidade O(I * V * k / T) com coordenadas (I iterações, T threads) e O(V^2) sem coordenadas.
+/// @param num_clusters Número de clusters pretendido.
+/// @param num_threads Número de threads usadas na atribuição do k-means.
+/// @return Vetor de clusters, cada um com os vértices que lhe pertencem (sem clusters vazios).
+std::vector<std::vector<int>> Graph::partitionVertices(int num_clusters, int num_threads) const {
+    int n = vertices.size();
+    num_clusters = std::max(1, std::min(num_clusters, n));
+    std::vector<int> assignment(n, 0);
+
+    if (hasCoordinates()) {
+        std::vector<double> lat(n), lon(n);
+        for (int v = 0; v < n; v++) {
+            lat[v] = vertices.at(v).lat;
+            lon[v] = vertices.at(v).longi;
+        }
+
+        // k-means++ seeding over squared planar distances
+        std::mt19937 rng(12345);
+        std::vector<double> c_lat, c_lon;
+        std::vector<double> closest(n, std::numeric_limits<double>::max());
+        int first = rng() % n;
+        c_lat.push_back(lat[first]);
+        c_lon.push_back(lon[first]);
+        while ((int)c_lat.size() < num_clusters) {
+            double total = 0.0;
+            for (int v = 0; v < n; v++) {
+                double dl = lat[v] - c_lat.back(), dg = lon[v] - c_lon.back();
+                closest[v] = std::min(closest[v], dl * dl + dg * dg);
+                total += closest[v];
+            }
+            if (total == 0.0) break;
+            double r = std::uniform_real_distribution<double>(0.0, total)(rng);
+            int chosen = n - 1;
+            for (int v = 0; v < n; v++) {
+                r -= closest[v];
+                if (r <= 0.0) {
+                    chosen = v;
+                    break;
+                }
+            }
+            c_lat.push_back(lat[chosen]);
+            c_lon.push_back(lon[chosen]);
+        }
+        int k = c_lat.size();
+
+        num_threads = std::max(1, num_threads);
+        for (int it = 0; it < 25; it++) {
+            std::vector<int> changed(num_threads, 0);
+            std::vector<std::thread> workers;
+            for (int t = 0; t < num_threads; t++) {
+                workers.emplace_back([&, t]() {
+                    for (int v = t; v < n; v += num_threads) {
+                        int best = 0;
+                        double best_d = std::numeric_limits<double>::max();
+                        for (int c = 0; c < k; c++) {
+                            double dl = lat[v] - c_lat[c], dg = lon[v] - c_lon[c];
+                            double d = dl * dl + dg * dg;
+                            if (d < best_d) {
+                                best_d = d;
+                                best = c;
+                            }
+                        }
+                        if (assignment[v] != best) {
+                            assignment[v] = best;
+                            changed[t]++;
+                        }
+                    }
+                });
+            }
+            for (std::thread& worker : workers) worker.join();
+
+            std::vector<double> sum_lat(k, 0.0), sum_lon(k, 0.0);
+            std::vector<int> count(k, 0);
+            for (int v = 0; v < n; v++) {
+                sum_lat[assignment[v]] += lat[v];
+                sum_lon[assignment[v]] += lon[v];
+                count[assignment[v]]++;
+            }
+            for (int c = 0; c < k; c++) {
+                if (count[c] > 0) {
+                    c_lat[c] = sum_lat[c] / count[c];
+                    c_lon[c] = sum_lon[c] / count[c];
+                }
+            }
+
+            int total_changed = 0;
+            for (int c : changed) total_changed += c;
+            if (it > 0 && total_changed == 0) break;
+        }
+        num_clusters = k;
+    } else {
+        // cut the heaviest MST edges; each remaining tree is a cluster
+        std::vector<int> parent(n, -1);
+        primMST(parent);
+
+        std::vector<std::pair<double, int>> tree_edges;
+        for (int v = 0; v < n; v++) {
+            if (parent[v] != -1) {
+                tree_edges.push_back(std::make_pair(travelCost(parent[v], v), v));
+            }
+        }
+        std::sort(tree_edges.begin(), tree_edges.end(), std::greater<std::pair<double, int>>());
+        for (int i = 0; i < num_clusters - 1 && i < (int)tree_edges.size(); i++) {
+            parent[tree_edges[i].second] = -1;
+        }
+
+        // walk each tree in preorder; the cuts alone can leave one giant tree (a long chain of light edges), so a tree
+        // above the size limit is split into equal runs of consecutive preorder vertices
+        std::vector<std::vector<int>> children(n);
+        for (int v = 0; v < n; v++) {
+            if (parent[v] != -1) children[parent[v]].push_back(v);
+        }
+        int max_size = CLUSTER_MAX_FACTOR * ((n + num_clusters - 1) / num_clusters);
+        int label = 0;
+        std::vector<int> order;
+        for (int root = 0; root < n; root++) {
+            if (parent[root] != -1) continue;
+            order.clear();
+            std::stack<int> stack;
+            stack.push(root);
+            while (!stack.empty()) {
+                int u = stack.top();
+                stack.pop();
+                order.push_back(u);
+                for (auto it = children[u].rbegin(); it != children[u].rend(); ++it) stack.push(*it);
+            }
+            int size = order.size();
+            int pieces = (size + max_size - 1) / max_size;
+            for (int i = 0; i < size; i++) {
+                assignment[order[i]] = label + (long long)i * pieces / size;
+            }
+            label += pieces;
+        }
+        num_clusters = label;
+    }
+
+    std::vector<std::vector<int>> clusters(num_clusters);
+    for (int v = 0; v < n; v++) {
+        clusters[assignment[v]].push_back(v);
+    }
+    clusters.erase(std::remove_if(clusters.begin(), clusters.end(),
+                                  [](const std::vector<int>& c) { return c.empty(); }),
+                   clusters.end());
+    return clusters;
+}
+
+/// @brief Repara as fronteiras entre sub-ciclos com 2-opt restrito a uma janela em torno de cada junção.
+/// O ciclo é tratado como circular, pelo que a junção onde o ciclo fecha (do último cluster para o primeiro) também é
+/// reparada.
+/// Esta função tem complexidade O(S * W^2) por passagem, onde S é o número de junções e W o tamanho da janela.
+/// @param tour Ciclo completo a reparar.
+/// @param seams Posições do ciclo onde começa cada cluster.
+/// @param window Número de posições consideradas para cada lado de uma junção.
+void Graph::repairSeams(std::vector<int>& tour, const std::vector<int>& seams, int window) const {
+    int n = tour.size();
+    if (n < 4) return;
+
+    int length = std::min(n, 2 * window + 1);
+    std::vector<int> pos(length);
+    for (int seam : seams) {
+        // tour positions covered by the window, wrapping around the end of the vector
+        for (int t = 0; t < length; t++) {
+            pos[t] = ((seam - window + t) % n + n) % n;
+        }
+
+        bool improved = true;
+        while (improved) {
+            improved = false;
+            for (int i = 0; i < length - 3; i++) {
+                for (int j = i + 2; j < length - 1; j++) {
+                    int a = tour[pos[i]], b = tour[pos[i + 1]], c = tour[pos[j]], d = tour[pos[j + 1]];
+                    double delta = travelCost(a, c) + travelCost(b, d) - travelCost(a, b) - travelCost(c, d);
+                    if (delta < -1e-9) {
+                        for (int l = i + 1, r = j; l < r; l++, r--) {
+                            std::swap(tour[pos[l]], tour[pos[r]]);
+                        }
+                        improved = true;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/// @brief Calcula um ciclo por divisão e conquista, para grafos grandes.
+/// Os vértices são divididos em clusters (partitionVertices), cada cluster é resolvido em paralelo com o vizinho mais
+/// próximo seguido de 2-opt sobre a sua matriz local, é calculado um ciclo sobre os clusters e os sub-ciclos são unidos pela ordem desse ciclo,
+/// sendo as junções reparadas com 2-opt local (repairSeams).
+/// Esta função tem complexidade aproximadamente O(V * s + (V/s)^2) para clusters de tamanho s.
+/// @param cluster_size Número de vértices pretendido em cada cluster.
+/// @param num_threads Número de threads usadas na resolução dos clusters.
+/// @return Vetor de inteiros, representando o ciclo encontrado.
+std::vector<int> Graph::clusteredTour(int cluster_size, int num_threads) const {
+    int n = vertices.size();
+    if (n == 0) return {};
+    num_threads = std::max(1, num_threads);
+    int num_clusters = (n + cluster_size - 1) / std::max(1, cluster_size);
+    std::vector<std::vector<int>> clusters = partitionVertices(num_clusters, num_threads);
+    int k = clusters.size();
+
+    // local matrices are built up front so that worker threads never touch the graph
+    std::vector<std::vector<double>> local_dist(k);
+    for (int c = 0; c < k; c++) {
+        int m = clusters[c].size();
+        local_dist[c].resize((size_t)m * m);
+        for (int i = 0; i < m; i++) {
+            for (int j = 0; j < m; j++) {
+                local_dist[c][(size_t)i * m + j] = i == j ? 0.0 : travelCost(clusters[c][i], clusters[c][j]);
+            }
+        }
+    }
+
+    std::vector<std::vector<int>> sub_tours(k);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < num_threads; t++) {
+        workers.emplace_back([&, t]() {
+            for (int c = t; c < k; c += num_threads) {
+                std::vector<int> local = solveLocal(local_dist[c], clusters[c].size());
+                for (int& v : local) v = clusters[c][v];
+                sub_tours[c] = local;
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+    local_dist.clear();
+
+    // tour over the clusters, using the first vertex of each sub-tour as its representative
+    std::vector<double> cluster_dist((size_t)k * k, 0.0);
+    for (int a = 0; a < k; a++) {
+        for (int b = 0; b < k; b++) {
+            if (a != b) cluster_dist[(size_t)a * k + b] = travelCost(sub_tours[a][0], sub_tours[b][0]);
+        }
+    }
+    std::vector<int> cluster_order = solveLocal(cluster_dist, k);
+
+    // stitch: enter each cluster at the vertex closest to the previous exit and walk its cycle
+    // in the direction whose last vertex is closest to the next cluster
+    std::vector<int> tour;
+    std::vector<int> seams;
+    tour.reserve(n);
+    for (int idx = 0; idx < k; idx++) {
+        const std::vector<int>& cycle = sub_tours[cluster_order[idx]];
+        int m = cycle.size();
+
+        int entry = 0;
+        if (!tour.empty()) {
+            double best = std::numeric_limits<double>::max();
+            for (int i = 0; i < m; i++) {
+                double d = travelCost(tour.back(), cycle[i]);
+                if (d < best) {
+                    best = d;
+                    entry = i;
+                }
+            }
+        }
+
+        int next_rep = sub_tours[cluster_order[(idx + 1) % k]][0];
+        int forward_exit = cycle[(entry + m - 1) % m];
+        int backward_exit = cycle[(entry + 1) % m];
+        int step = travelCost(forward_exit, next_rep) <= travelCost(backward_exit, next_rep) ? 1 : m - 1;
+
+        seams.push_back(tour.size());
+        for (int i = 0, pos = entry; i < m; i++, pos = (pos + step) % m) {
+            tour.push_back(cycle[pos]);
+        }
+    }
+
+    repairSeams(tour, seams, 25);
+    return tour;
+}
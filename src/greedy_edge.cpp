@@ -0,0 +1,158 @@
+#include "utils/graph.h"
+#include "utils/union_find.h"
+
+#include <array>
+#include <thread>
+
+/// @brief Ordena arestas por distância crescente com radix sort LSD paralelo.
+/// As distâncias são quantizadas para chaves de 32 bits (relativas à maior distância) e ordenadas em 4 passagens de
+/// 8 bits; em cada passagem cada thread conta e distribui o seu bloco, pelo que a ordenação é estável.
+/// Esta função tem complexidade O(E / T + T * 256) por passagem.
+/// @param edges Arestas a ordenar (distâncias não negativas).
+/// @param num_threads Número de threads.
+static void radixSortEdges(std::vector<Edge>& edges, int num_threads) {
+    size_t m = edges.size();
+    if (m < 2) return;
+    num_threads = std::max(1, std::min(num_threads, (int)(m / 65536) + 1));
+
+    double max_distance = 0.0;
+    for (const Edge& edge : edges) max_distance = std::max(max_distance, edge.distance);
+    double scale = max_distance > 0.0 ? 4294967295.0 / max_distance : 0.0;
+
+    std::vector<uint32_t> keys(m), keys_out(m);
+    std::vector<Edge> edges_out(m);
+    for (size_t i = 0; i < m; i++) {
+        keys[i] = (uint32_t)std::min(4294967295.0, std::max(0.0, edges[i].distance * scale));
+    }
+
+    std::vector<std::vector<size_t>> count(num_threads, std::vector<size_t>(256));
+    auto chunk = [&](int t) { return std::make_pair(m * t / num_threads, m * (t + 1) / num_threads); };
+
+    for (int shift = 0; shift < 32; shift += 8) {
+        auto histogram = [&](int t) {
+            std::fill(count[t].begin(), count[t].end(), 0);
+            for (size_t i = chunk(t).first; i < chunk(t).second; i++) count[t][(keys[i] >> shift) & 255]++;
+        };
+        auto scatter = [&](int t, std::vector<size_t> offset) {
+            for (size_t i = chunk(t).first; i < chunk(t).second; i++) {
+                size_t dest = offset[(keys[i] >> shift) & 255]++;
+                keys_out[dest] = keys[i];
+                edges_out[dest] = edges[i];
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (int t = 1; t < num_threads; t++) workers.emplace_back(histogram, t);
+        histogram(0);
+        for (std::thread& worker : workers) worker.join();
+        workers.clear();
+
+        // each (digit, thread) block starts after every smaller digit and every earlier thread with the same digit
+        std::vector<std::vector<size_t>> offset(num_threads, std::vector<size_t>(256));
+        size_t total = 0;
+        for (int digit = 0; digit < 256; digit++) {
+            for (int t = 0; t < num_threads; t++) {
+                offset[t][digit] = total;
+                total += count[t][digit];
+            }
+        }
+
+        for (int t = 1; t < num_threads; t++) workers.emplace_back(scatter, t, offset[t]);
+        scatter(0, offset[0]);
+        for (std::thread& worker : workers) worker.join();
+
+        keys.swap(keys_out);
+        edges.swap(edges_out);
+    }
+}
+
+/// @brief Constrói um ciclo com a heurística greedy edge (greedy matching).
+/// As arestas candidatas são ordenadas por distância e aceites enquanto os dois extremos tiverem grau inferior a 2 e
+/// não fecharem um ciclo (verificado com union-find). Os caminhos resultantes são depois ligados pelo extremo livre
+/// mais próximo, segundo travelCost.
+/// As candidatas são as arestas do grafo (ou todos os pares, se o grafo só tiver coordenadas) quando neighbours <= 0,
+/// ou as arestas para os neighbours vértices mais próximos de cada vértice.
+/// Esta função tem complexidade O(E + F^2), onde E é o número de candidatas e F o número de caminhos a ligar.
+/// @param neighbours Número de candidatos por vértice (<= 0 para usar todas as arestas).
+/// @param num_threads Número de threads usadas na ordenação.
+/// @return Ciclo como permutação de todos os vértices.
+std::vector<int> Graph::greedyEdgeTour(int neighbours, int num_threads) const {
+    int n = vertices.size();
+    if (n == 0) return {};
+
+    std::vector<Edge> edges;
+    if (neighbours > 0) {
+        std::vector<std::vector<int>> candidates = nearestCandidates(neighbours);
+        for (int u = 0; u < n; u++) {
+            for (int v : candidates[u]) {
+                // pairs that are candidates of each other are kept once
+                if (u < v || std::find(candidates[v].begin(), candidates[v].end(), u) == candidates[v].end()) {
+                    edges.push_back({std::min(u, v), std::max(u, v), travelCost(u, v)});
+                }
+            }
+        }
+    } else if (num_edges > 0) {
+        for (auto& vertex : vertices) {
+            for (const edgeNode& edge : vertex.second.adj) {
+                if (vertex.first < edge.vertex) edges.push_back({vertex.first, edge.vertex, edge.distance});
+            }
+        }
+    } else {
+        edges.reserve((size_t)n * (n - 1) / 2);
+        for (int u = 0; u < n; u++) {
+            for (int v = u + 1; v < n; v++) edges.push_back({u, v, travelCost(u, v)});
+        }
+    }
+
+    radixSortEdges(edges, num_threads);
+
+    // link[v] holds the (up to two) chosen neighbours of v
+    std::vector<std::array<int, 2>> link(n, {-1, -1});
+    UnionFind fragments(n);
+    int accepted = 0;
+    for (const Edge& edge : edges) {
+        if (accepted == n - 1) break;
+        int u = edge.origin, v = edge.dest;
+        if (link[u][1] != -1 || link[v][1] != -1) continue;
+        if (!fragments.unite(u, v)) continue;
+        link[u][link[u][0] == -1 ? 0 : 1] = v;
+        link[v][link[v][0] == -1 ? 0 : 1] = u;
+        accepted++;
+    }
+
+    // join the paths: walk one to its far end, then jump to the nearest free endpoint of another path
+    std::vector<int> endpoints;
+    for (int v = 0; v < n; v++) {
+        if (link[v][1] == -1) endpoints.push_back(v);
+    }
+    std::vector<bool> visited(n, false);
+    std::vector<int> tour;
+    tour.reserve(n);
+
+    int current = endpoints[0];
+    while (true) {
+        int previous = -1;
+        while (current != -1) {
+            tour.push_back(current);
+            visited[current] = true;
+            int next = link[current][0] == previous ? link[current][1] : link[current][0];
+            previous = current;
+            current = next != -1 && !visited[next] ? next : -1;
+        }
+        if ((int)tour.size() == n) break;
+
+        int best = -1;
+        double best_cost = std::numeric_limits<double>::max();
+        for (int v : endpoints) {
+            if (visited[v]) continue;
+            double cost = travelCost(previous, v);
+            if (cost < best_cost) {
+                best_cost = cost;
+                best = v;
+            }
+        }
+        current = best;
+    }
+
+    return tour;
+}
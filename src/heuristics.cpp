@@ -1,4 +1,5 @@
 #include "utils/graph.h"
+#include "utils/metric_closure.h"
 
 /// @brief Encontra o ciclo hamiltoniano de menor custo em um grafo.
 /// Esta função tem complexidade O(n!), onde n é o número de vértices do grafo.
@@ -13,7 +14,7 @@ void Graph::tsp_backtrack(std::vector<int>& path, std::vector<bool>& visited, do
         // Check if the last vertex is adjacent to the starting vertex
         int start_vertex = path.front();
         int last_vertex = path.back();
-        for (auto edge : vertices[last_vertex].adj) {
+        for (auto edge : vertices.at(last_vertex).adj) {
             if (edge.vertex == start_vertex) {
                 // If it is, this is a Hamiltonian cycle; update the minimum cost if necessary
                 double cycle_cost = cost_so_far + edge.distance;
@@ -28,7 +29,7 @@ void Graph::tsp_backtrack(std::vector<int>& path, std::vector<bool>& visited, do
 
     // Recursively consider all unvisited neighbors of the last vertex in the current path
     int last_vertex = path.back();
-    for (auto edge : vertices[last_vertex].adj) {
+    for (auto edge : vertices.at(last_vertex).adj) {
         if (!visited[edge.vertex]) {
             // Add the next vertex to the current path
             path.push_back(edge.vertex);
@@ -42,20 +43,192 @@ void Graph::tsp_backtrack(std::vector<int>& path, std::vector<bool>& visited, do
     }
 }
 
+/// @brief Calcula o custo da aresta de saída mais barata de cada vértice, usado nos cortes do branch-and-bound.
+/// Esta função tem complexidade O(V + E).
+/// @return Vetor com o custo mínimo de saída de cada vértice (0 se o vértice não tiver arestas).
+std::vector<double> Graph::cheapestOutgoingEdges() const {
+    std::vector<double> min_out(vertices.size(), 0.0);
+    for (auto& vertex : vertices) {
+        double cheapest = std::numeric_limits<double>::max();
+        for (const edgeNode& edge : vertex.second.adj) {
+            cheapest = std::min(cheapest, edge.distance);
+        }
+        if (!vertex.second.adj.empty()) min_out[vertex.first] = cheapest;
+    }
+    return min_out;
+}
+
+/// @brief Constrói a matriz de pesos das arestas, usada no corte por árvore geradora do branch-and-bound.
+/// Ao contrário de buildDistanceMatrix, os pares sem aresta ficam com custo infinito, porque a pesquisa nunca os usa.
+/// Esta função tem complexidade O(V^2 + E).
+/// @return Vetor com V*V pesos (row-major), o menor de cada par se houver arestas paralelas.
+std::vector<double> Graph::edgeWeightMatrix() const {
+    int n = vertices.size();
+    std::vector<double> weights((size_t)n * n, std::numeric_limits<double>::infinity());
+    for (const auto& vertex : vertices) {
+        for (const edgeNode& edge : vertex.second.adj) {
+            double& w = weights[(size_t)vertex.first * n + edge.vertex];
+            w = std::min(w, edge.distance);
+        }
+    }
+    return weights;
+}
+
+/// @brief Limite inferior do custo que falta para fechar o ciclo a partir de um prefixo: qualquer conclusão é um caminho
+/// hamiltoniano do último vértice ao primeiro pelos vértices por visitar, que sem as duas arestas dos extremos é uma
+/// árvore geradora desses vértices. O limite é a árvore geradora mínima (Prim denso) mais a aresta mais barata do
+/// último vértice para o conjunto e do conjunto para o primeiro.
+/// Esta função tem complexidade O(U^2), onde U é o número de vértices por visitar.
+/// @return Limite inferior, infinito se os vértices por visitar não puderem ser ligados.
+static double remainingTreeBound(const std::vector<double>& weights, int first, int last, const std::vector<bool>& visited) {
+    int n = visited.size();
+    std::vector<int> rest;
+    for (int v = 0; v < n; v++) {
+        if (!visited[v]) rest.push_back(v);
+    }
+    int m = rest.size();
+    const double inf = std::numeric_limits<double>::infinity();
+
+    double enter = inf, leave = inf;
+    for (int v : rest) {
+        enter = std::min(enter, weights[(size_t)last * n + v]);
+        leave = std::min(leave, weights[(size_t)v * n + first]);
+    }
+    double total = enter + leave;
+
+    std::vector<double> key(m, inf);
+    std::vector<bool> in_tree(m, false);
+    key[0] = 0.0;
+    for (int added = 0; added < m && total < inf; added++) {
+        int u = -1;
+        for (int i = 0; i < m; i++) {
+            if (!in_tree[i] && (u == -1 || key[i] < key[u])) u = i;
+        }
+        in_tree[u] = true;
+        total += key[u];
+        const double* row = &weights[(size_t)rest[u] * n];
+        for (int i = 0; i < m; i++) {
+            // the path may run either way along an edge, so the cheaper direction bounds it
+            double w = std::min(row[rest[i]], weights[(size_t)rest[i] * n + rest[u]]);
+            if (!in_tree[i] && w < key[i]) key[i] = w;
+        }
+    }
+    return total;
+}
+
+/// @brief Encontra o ciclo hamiltoniano de menor custo em um grafo, por branch-and-bound.
+/// Um ramo é cortado quando o custo parcial mais a aresta de saída mais barata do último vértice e de cada vértice
+/// por visitar não melhora o melhor ciclo encontrado. Com a matriz bound.weights, enquanto faltarem pelo menos
+/// BRANCH_AND_BOUND_TREE_VERTICES vértices, também é cortado quando o custo parcial mais a árvore geradora mínima dos
+/// vértices por visitar e as arestas que a ligam aos extremos do prefixo (remainingTreeBound) não o melhora. A pesquisa termina mais cedo quando a distância relativa entre
+/// o melhor ciclo e o limite inferior global (Held-Karp) fica abaixo de bound.gap_threshold.
+/// Num portefólio a pesquisa também corta com o melhor custo dos outros solvers (bound.shared_cost), avisa cada novo
+/// melhor ciclo (bound.on_improvement) e pára quando bound.cancel fica ativo; o grafo só é lido.
+/// Quando bound.suspend fica ativo a pesquisa pára sem perder trabalho: bound.frontier recebe o nó atual e os irmãos por
+/// explorar de cada antecessor, e continuar a pesquisa a partir desses prefixos, pela ordem, equivale a não ter parado.
+/// Esta função tem complexidade O(n!) no pior caso, onde n é o número de vértices do grafo.
+/// @param path Vetor de inteiros, onde cada inteiro é um vértice do ciclo.
+/// @param visited Vetor de booleanos, onde cada booleano indica se o vértice correspondente já foi visitado.
+/// @param min_cost Referência para o custo do ciclo hamiltoniano de menor custo encontrado até o momento.
+/// @param cost_so_far Custo do ciclo hamiltoniano parcialmente construído até o momento.
+/// @param bound Estado do branch-and-bound (limites, melhor caminho e contadores).
+void Graph::tsp_branch_and_bound(std::vector<int>& path, std::vector<bool>& visited, double &min_cost, double cost_so_far, SearchBound& bound) const {
+    if (bound.stop) return;
+    if (bound.cancel != nullptr && bound.cancel->load(std::memory_order_relaxed)) {
+        bound.stop = true;
+        return;
+    }
+    if (bound.suspend != nullptr && bound.suspend->load(std::memory_order_relaxed)) {
+        // this node is kept whole; the callers add their unexplored siblings while unwinding
+        bound.suspended = true;
+        bound.stop = true;
+        bound.frontier.push_back(path);
+        return;
+    }
+    bound.expanded_nodes++;
+
+    int last_vertex = path.back();
+    if (path.size() == vertices.size()) {
+        int start_vertex = path.front();
+        for (const edgeNode& edge : vertices.at(last_vertex).adj) {
+            if (edge.vertex == start_vertex) {
+                double cycle_cost = cost_so_far + edge.distance;
+                if (cycle_cost < min_cost) {
+                    min_cost = cycle_cost;
+                    bound.best_path = path;
+                    if (bound.on_improvement) bound.on_improvement(min_cost, path);
+                    if (bound.lower_bound > 0 && min_cost - bound.lower_bound <= bound.gap_threshold * bound.lower_bound) {
+                        bound.stop = true;
+                    }
+                }
+                break;
+            }
+        }
+        return;
+    }
+
+    // every unvisited vertex, and the last one, still has to be left through some edge
+    double upper = min_cost;
+    if (bound.shared_cost != nullptr) upper = std::min(upper, bound.shared_cost->load(std::memory_order_relaxed));
+    if (cost_so_far + bound.min_out[last_vertex] + bound.remaining_min_out >= upper) return;
+    int remaining_vertices = vertices.size() - path.size();
+    if (bound.weights != nullptr && remaining_vertices >= BRANCH_AND_BOUND_TREE_VERTICES &&
+        cost_so_far + remainingTreeBound(*bound.weights, path.front(), last_vertex, visited) >= upper) return;
+
+    const std::vector<edgeNode>& adj = vertices.at(last_vertex).adj;
+    for (size_t i = 0; i < adj.size(); i++) {
+        const edgeNode& edge = adj[i];
+        if (!visited[edge.vertex]) {
+            double remaining = bound.remaining_min_out;
+            path.push_back(edge.vertex);
+            visited[edge.vertex] = true;
+            bound.remaining_min_out -= bound.min_out[edge.vertex];
+
+            tsp_branch_and_bound(path, visited, min_cost, cost_so_far + edge.distance, bound);
+
+            bound.remaining_min_out = remaining;
+            path.pop_back();
+            visited[edge.vertex] = false;
+            if (bound.stop) {
+                if (bound.suspended) {
+                    // siblings not explored yet, once per vertex: a resumed prefix follows the cheapest parallel edge
+                    size_t first = bound.frontier.size();
+                    for (size_t j = i + 1; j < adj.size(); j++) {
+                        int v = adj[j].vertex;
+                        if (visited[v]) continue;
+                        auto same = [v](const std::vector<int>& prefix) { return prefix.back() == v; };
+                        if (std::any_of(bound.frontier.begin() + first, bound.frontier.end(), same)) continue;
+                        path.push_back(v);
+                        bound.frontier.push_back(path);
+                        path.pop_back();
+                    }
+                }
+                return;
+            }
+        }
+    }
+}
+
 /// @brief Calcula uma solução aproximada para o problema TSP, utilizando aproximação triangular.
 /// É construída uma MST do grafo utilizando o algoritmo de Prim, e então é feita uma DFS na MST para obter a ordem de visitação das cidades.
 /// Esta função tem complexidade O(V^2), onde V é o número de vértices do grafo.
 /// @return Distância total percorrida na solução aproximada.
-double Graph::triangularApproximation() {
+double Graph::triangularApproximation() const {
     // Create the MST using Prim's algorithm
     std::vector<int> parent(vertices.size(), -1);
     primMST(parent);
+    return triangularApproximation(parent);
+}
 
-    // Perform DFS traversal to obtain the order of visited cities
-    std::vector<bool> visited(vertices.size(), false);
-    std::vector<int> path;
-    std::stack<int> cityStack;
-    dfs(0, parent, visited, cityStack, path);
+/// @brief Aproximação triangular sobre uma MST já calculada (por exemplo pelo Prim vetorizado de densePrimT): é feita
+/// uma DFS na MST para obter a ordem de visitação das cidades.
+/// Esta função tem complexidade O(V^2), onde V é o número de vértices do grafo.
+/// @param parent Pai de cada vértice na MST enraizada no vértice 0 (-1 na raiz e nos vértices fora da árvore).
+/// @return Distância total percorrida na solução aproximada.
+double Graph::triangularApproximation(const std::vector<int>& parent) const {
+    std::cout << "Minimum Spanning Tree:" << std::endl;
+
+    std::vector<int> path = mstPreorder(parent);
 
     // Print the order of visited cities
     /*std::cout << "Order of visited cities: ";
@@ -71,6 +244,117 @@ double Graph::triangularApproximation() {
     return total_distance;
 }
 
+/// @brief Ordem de visitação das cidades na aproximação triangular: DFS na MST a partir do vértice 0. Não imprime nada
+/// e só lê o grafo, pelo que pode correr em paralelo com outros solvers (portefólio).
+/// Esta função tem complexidade O(V^2).
+/// @param parent Pai de cada vértice na MST enraizada no vértice 0 (-1 na raiz e nos vértices fora da árvore).
+/// @return Vértices pela ordem da DFS (só os alcançáveis a partir do vértice 0).
+std::vector<int> Graph::mstPreorder(const std::vector<int>& parent) const {
+    // Perform DFS traversal to obtain the order of visited cities
+    std::vector<bool> visited(vertices.size(), false);
+    std::vector<int> path;
+    std::stack<int> cityStack;
+    dfs(0, parent, visited, cityStack, path);
+    return path;
+}
 
+/// @brief Vizinho mais próximo sobre uma matriz de distâncias dada; como a matriz é completa, o caminho passa sempre
+/// por todos os vértices. Empates são resolvidos pelo menor índice.
+/// Esta função tem complexidade O(n^2).
+/// @param dist Matriz de distâncias n*n (row-major).
+/// @param n Número de vértices da matriz.
+/// @param start_vertex Índice do vértice inicial.
+/// @return Caminho com os n vértices, a começar em start_vertex.
+std::vector<int> Graph::nearestNeighbourOnMatrix(const std::vector<double>& dist, int n, int start_vertex) {
+    std::vector<int> path;
+    path.reserve(n);
+    std::vector<bool> visited(n, false);
 
+    int current_vertex = start_vertex;
+    path.push_back(current_vertex);
+    visited[current_vertex] = true;
 
+    while ((int)path.size() < n) {
+        const double* row = &dist[(size_t)current_vertex * n];
+        int next_vertex = -1;
+        for (int v = 0; v < n; v++) {
+            if (!visited[v] && (next_vertex == -1 || row[v] < row[next_vertex])) next_vertex = v;
+        }
+        path.push_back(next_vertex);
+        visited[next_vertex] = true;
+        current_vertex = next_vertex;
+    }
+
+    return path;
+}
+
+/// @brief Vizinho mais próximo sobre a closure métrica do grafo.
+/// Ao contrário de nearestNeighbour, o próximo vértice não tem de ser adjacente: é o vértice por visitar com menor
+/// distância de caminho mais curto, pelo que funciona em qualquer grafo esparso ligado.
+/// Esta função tem complexidade O(V^2) mais o cálculo das linhas da closure que não estejam em cache.
+/// @param start_vertex Índice do vértice inicial.
+/// @param closure Closure métrica do grafo.
+/// @return Retorna um vetor de inteiros, representando o ciclo (sem os vértices intermédios dos caminhos).
+std::vector<int> Graph::nearestNeighbourClosure(int start_vertex, MetricClosure& closure) const {
+    int n = vertices.size();
+    std::vector<int> path;
+    std::vector<bool> visited(n, false);
+
+    int current_vertex = start_vertex;
+    path.push_back(current_vertex);
+    visited[current_vertex] = true;
+
+    while ((int)path.size() < n) {
+        std::shared_ptr<const ClosureRow> row = closure.row(current_vertex);
+        int next_vertex = -1;
+        double min_distance = std::numeric_limits<double>::infinity();
+
+        for (int v = 0; v < n; v++) {
+            if (!visited[v] && row->distance[v] < min_distance) {
+                next_vertex = v;
+                min_distance = row->distance[v];
+            }
+        }
+
+        // the remaining vertices are in another component
+        if (next_vertex == -1) {
+            break;
+        }
+
+        path.push_back(next_vertex);
+        visited[next_vertex] = true;
+        current_vertex = next_vertex;
+    }
+
+    return path;
+}
+
+/// @brief Calcula o custo de um ciclo usando distâncias de caminho mais curto.
+/// @param path Vetor de inteiros, representando o ciclo.
+/// @param closure Closure métrica do grafo.
+/// @return Custo do ciclo (infinito se algum vértice não for alcançável a partir do anterior).
+double Graph::closureTourCost(const std::vector<int>& path, MetricClosure& closure) const {
+    double total = 0.0;
+    for (int i = 0; i < (int)path.size(); i++) {
+        total += closure.distance(path[i], path[(i + 1) % path.size()]);
+    }
+    return total;
+}
+
+/// @brief Expande um ciclo sobre a closure no percurso real, inserindo os vértices intermédios de cada caminho.
+/// @param path Vetor de inteiros, representando o ciclo.
+/// @param closure Closure métrica do grafo.
+/// @return Percurso real, que começa e acaba no primeiro vértice do ciclo.
+std::vector<int> Graph::expandTour(const std::vector<int>& path, MetricClosure& closure) const {
+    std::vector<int> route;
+    if (path.empty()) return route;
+    route.push_back(path[0]);
+
+    for (int i = 0; i < (int)path.size(); i++) {
+        std::vector<int> leg = closure.expandPath(path[i], path[(i + 1) % path.size()]);
+        for (int j = 1; j < (int)leg.size(); j++) {
+            route.push_back(leg[j]);
+        }
+    }
+    return route;
+}
@@ -0,0 +1,168 @@
+#include "utils/graph.h"
+#include "utils/tour.h"
+
+/// @brief Calcula, para cada vértice, os k vértices mais próximos segundo travelCost, sem percorrer todos os pares.
+/// Com coordenadas, os vértices são distribuídos por uma grelha uniforme (projeção equirretangular) com cerca de
+/// CANDIDATE_GRID_DENSITY vértices por célula; cada vértice percorre anéis de células à sua volta até ter k vértices
+/// dentro do raio já coberto, e os vértices recolhidos são ordenados por travelCost.
+/// Sem coordenadas, os pares sem aresta custam 0 e não servem de candidatos, pelo que os candidatos são os k vizinhos
+/// mais baratos da lista de adjacência.
+/// Esta função tem complexidade O(V * k log k) com pontos bem distribuídos e O(V + E log k) sem coordenadas.
+/// @param k Número de candidatos por vértice.
+/// @return Listas de candidatos, ordenadas por distância crescente (podem ter menos de k vértices sem coordenadas).
+std::vector<std::vector<int>> Graph::nearestCandidates(int k) const {
+    int n = vertices.size();
+    k = std::min(k, n - 1);
+    std::vector<std::vector<int>> candidates(n);
+    if (k <= 0) return candidates;
+
+    if (!hasCoordinates()) {
+        std::vector<std::pair<double, int>> order;
+        std::vector<int> seen(n, -1);
+        for (int u = 0; u < n; u++) {
+            order.clear();
+            for (const edgeNode& edge : vertices.at(u).adj) {
+                if (edge.vertex != u) order.push_back(std::make_pair(edge.distance, edge.vertex));
+            }
+            std::sort(order.begin(), order.end());
+            // parallel edges: the cheapest one comes first
+            for (const auto& entry : order) {
+                if ((int)candidates[u].size() == k) break;
+                if (seen[entry.second] == u) continue;
+                seen[entry.second] = u;
+                candidates[u].push_back(entry.second);
+            }
+        }
+        return candidates;
+    }
+
+    // planar coordinates; the grid only has to find the neighbourhood, the final order uses travelCost
+    std::vector<double> xs(n), ys(n);
+    double mean_lat = 0.0;
+    for (int v = 0; v < n; v++) mean_lat += vertices.at(v).lat;
+    double scale = std::cos(mean_lat / n * M_PI / 180.0);
+    for (int v = 0; v < n; v++) {
+        xs[v] = vertices.at(v).longi * scale;
+        ys[v] = vertices.at(v).lat;
+    }
+    double min_x = *std::min_element(xs.begin(), xs.end()), max_x = *std::max_element(xs.begin(), xs.end());
+    double min_y = *std::min_element(ys.begin(), ys.end()), max_y = *std::max_element(ys.begin(), ys.end());
+    double width = max_x - min_x, height = max_y - min_y;
+    double cells_wanted = std::max(1.0, (double)n / CANDIDATE_GRID_DENSITY);
+    double side = std::sqrt(std::max(width * height, 1e-18) / cells_wanted);
+    side = std::max(side, std::max(width, height) / cells_wanted);
+    if (side <= 0.0) side = 1.0;
+    int cols = (int)(width / side) + 1, rows = (int)(height / side) + 1;
+
+    // vertices bucketed by cell, in compressed (CSR) form
+    std::vector<int> cell_of(n), cell_start((size_t)cols * rows + 1, 0), cell_items(n);
+    for (int v = 0; v < n; v++) {
+        int cx = std::min(cols - 1, (int)((xs[v] - min_x) / side));
+        int cy = std::min(rows - 1, (int)((ys[v] - min_y) / side));
+        cell_of[v] = cy * cols + cx;
+        cell_start[cell_of[v] + 1]++;
+    }
+    for (size_t c = 0; c < (size_t)cols * rows; c++) cell_start[c + 1] += cell_start[c];
+    std::vector<int> fill(cell_start.begin(), cell_start.end() - 1);
+    for (int v = 0; v < n; v++) cell_items[fill[cell_of[v]]++] = v;
+
+    std::vector<std::pair<double, int>> found;
+    for (int u = 0; u < n; u++) {
+        int cx = cell_of[u] % cols, cy = cell_of[u] / cols;
+        found.clear();
+        int within = 0;
+        for (int r = 0; ; r++) {
+            // cells on the ring at Chebyshev distance r from the vertex's cell
+            for (int y = cy - r; y <= cy + r; y++) {
+                if (y < 0 || y >= rows) continue;
+                int step = (y == cy - r || y == cy + r) ? 1 : 2 * r;
+                for (int x = cx - r; x <= cx + r; x += std::max(step, 1)) {
+                    if (x < 0 || x >= cols) continue;
+                    int c = y * cols + x;
+                    for (int i = cell_start[c]; i < cell_start[c + 1]; i++) {
+                        int v = cell_items[i];
+                        if (v == u) continue;
+                        double dx = xs[v] - xs[u], dy = ys[v] - ys[u];
+                        found.push_back(std::make_pair(dx * dx + dy * dy, v));
+                    }
+                }
+            }
+            // every vertex within r cells of u has been seen once the ring is done
+            double radius = r * side;
+            within = 0;
+            for (const auto& entry : found) {
+                if (entry.first <= radius * radius) within++;
+            }
+            bool covers_grid = cx - r <= 0 && cy - r <= 0 && cx + r >= cols - 1 && cy + r >= rows - 1;
+            if (within >= k || covers_grid) break;
+        }
+
+        for (auto& entry : found) entry.first = travelCost(u, entry.second);
+        int take = std::min(k, (int)found.size());
+        std::partial_sort(found.begin(), found.begin() + take, found.end());
+        for (int i = 0; i < take; i++) candidates[u].push_back(found[i].second);
+    }
+
+    return candidates;
+}
+
+/// @brief Melhora um ciclo com 2-opt, usando listas de candidatos e don't-look bits.
+/// O ciclo é guardado na representação devolvida por makeTour (array ou lista de dois níveis), para que cada movimento
+/// custe O(sqrt(n)) em grafos grandes. Em grafos até DENSE_MATRIX_VERTICES vértices as distâncias vêm da matriz.
+/// Esta função tem complexidade O(M * (k + sqrt(V))), onde M é o número de movimentos aplicados.
+/// @param path Ciclo a melhorar (permutação de todos os vértices); é substituído pelo ciclo melhorado.
+/// @param neighbours Número de candidatos considerados por vértice.
+/// @param target_cost A pesquisa termina assim que o custo do ciclo for <= target_cost (0 para desativar).
+/// @param use_matrix False para ler sempre as distâncias do grafo (travelCost), mesmo em grafos pequenos.
+/// @return Nome da representação de ciclo usada.
+std::string Graph::twoOpt(std::vector<int>& path, int neighbours, double target_cost, bool use_matrix) const {
+    int n = path.size();
+    std::unique_ptr<Tour> tour = makeTour(path);
+    if (n < 5) return tour->name();
+
+    std::vector<double> dist;
+    if (use_matrix && n <= DENSE_MATRIX_VERTICES) dist = buildDistanceMatrix();
+    auto cost = [&](int u, int v) {
+        return dist.empty() ? travelCost(u, v) : dist[(size_t)u * n + v];
+    };
+
+    std::vector<std::vector<int>> candidates = nearestCandidates(neighbours);
+    double current = calculateTotalDistance(path);
+    twoOptMoves(*tour, path[0], candidates, cost, current, target_cost);
+
+    path = tour->toVector(path[0]);
+    return tour->name();
+}
+
+/// @brief Melhora um ciclo com 2-opt sobre uma matriz de distâncias dada (por exemplo a da closure métrica), com
+/// listas de candidatos tiradas da própria matriz e don't-look bits.
+/// Esta função tem complexidade O(V^2 * log k + M * (k + sqrt(V))), onde M é o número de movimentos aplicados.
+/// @param path Ciclo a melhorar (permutação de todos os vértices); é substituído pelo ciclo melhorado.
+/// @param dist Matriz de distâncias n*n (row-major).
+/// @param neighbours Número de candidatos considerados por vértice.
+/// @param target_cost A pesquisa termina assim que o custo do ciclo for <= target_cost (0 para desativar).
+/// @return Custo do ciclo melhorado, segundo a matriz.
+double Graph::twoOptOnMatrix(std::vector<int>& path, const std::vector<double>& dist, int neighbours, double target_cost) {
+    int n = path.size();
+    auto cost = [&](int u, int v) { return dist[(size_t)u * n + v]; };
+    double current = 0.0;
+    for (int i = 0; i < n; i++) current += cost(path[i], path[(i + 1) % n]);
+    if (n < 5) return current;
+
+    int k = std::min(neighbours, n - 1);
+    std::vector<std::vector<int>> candidates(n);
+    std::vector<int> order;
+    for (int u = 0; u < n; u++) {
+        order.clear();
+        for (int v = 0; v < n; v++) {
+            if (v != u) order.push_back(v);
+        }
+        std::partial_sort(order.begin(), order.begin() + k, order.end(), [&](int a, int b) { return cost(u, a) < cost(u, b); });
+        candidates[u].assign(order.begin(), order.begin() + k);
+    }
+
+    std::unique_ptr<Tour> tour = makeTour(path);
+    twoOptMoves(*tour, path[0], candidates, cost, current, target_cost);
+    path = tour->toVector(path[0]);
+    return current;
+}
@@ -0,0 +1,133 @@
+#include "utils/graph.h"
+
+/// @brief Calcula o custo de uma 1-tree mínima sobre os pesos modificados w(i, j) + pi[i] + pi[j].
+/// A 1-tree é uma MST dos vértices 1..V-1 (Prim em O(V^2), adequado a grafos densos) mais as duas
+/// arestas mais baratas que ligam o vértice 0 ao resto da árvore.
+/// Esta função tem complexidade O(V^2), onde V é o número de vértices do grafo.
+/// @param dist Matriz de distâncias (row-major), obtida com buildDistanceMatrix.
+/// @param pi Penalização de cada vértice.
+/// @param degree Vetor onde é guardado o grau de cada vértice na 1-tree.
+/// @return Custo da 1-tree com os pesos modificados, menos 2 * soma(pi), que é um limite inferior do TSP.
+double Graph::oneTree(const std::vector<double>& dist, const std::vector<double>& pi, std::vector<int>& degree) const {
+    int n = pi.size();
+    std::vector<double> key(n, std::numeric_limits<double>::max());
+    std::vector<int> parent(n, -1);
+    std::vector<bool> inTree(n, false);
+    std::fill(degree.begin(), degree.end(), 0);
+
+    double cost = 0.0;
+    key[1] = 0.0;
+
+    // Prim sem fila de prioridade: cada iteração escolhe o vértice de menor chave numa passagem linear
+    for (int it = 1; it < n; it++) {
+        int u = -1;
+        for (int v = 1; v < n; v++) {
+            if (!inTree[v] && (u == -1 || key[v] < key[u])) {
+                u = v;
+            }
+        }
+
+        inTree[u] = true;
+        cost += key[u];
+        if (parent[u] != -1) {
+            degree[u]++;
+            degree[parent[u]]++;
+        }
+
+        const double* row = &dist[(size_t)u * n];
+        for (int v = 1; v < n; v++) {
+            if (inTree[v]) continue;
+            double w = row[v] + pi[u] + pi[v];
+            if (w < key[v]) {
+                key[v] = w;
+                parent[v] = u;
+            }
+        }
+    }
+
+    // two cheapest edges leaving the special vertex 0
+    double first = std::numeric_limits<double>::max(), second = first;
+    int first_v = -1, second_v = -1;
+    for (int v = 1; v < n; v++) {
+        double w = dist[v] + pi[0] + pi[v];
+        if (w < first) {
+            second = first;
+            second_v = first_v;
+            first = w;
+            first_v = v;
+        } else if (w < second) {
+            second = w;
+            second_v = v;
+        }
+    }
+    cost += first + second;
+    degree[0] = 2;
+    degree[first_v]++;
+    degree[second_v]++;
+
+    for (double p : pi) {
+        cost -= 2.0 * p;
+    }
+    return cost;
+}
+
+/// @brief Calcula o limite inferior de Held-Karp para o TSP, por otimização subgradiente das penalizações dos vértices.
+/// Em cada iteração é calculada a 1-tree mínima com os pesos modificados e as penalizações são ajustadas na direção
+/// (grau - 2), com passo proporcional à distância a um ciclo de referência (vizinho
+/// mais próximo melhorado com 2-opt, calculado aqui), para que o limite não dependa de quem o pede primeiro.
+/// O passo é reduzido a metade sempre que o limite não melhora durante HELD_KARP_PERIOD iterações; o método converge
+/// quando o passo se torna desprezável, quando a 1-tree é um ciclo ou quando o limite atinge o limite superior.
+/// Esta função tem complexidade O(I * V^2), onde I é o número de iterações e V o número de vértices do grafo.
+/// @param max_iterations Número máximo de iterações do método subgradiente.
+/// @param upper_bound Custo de um ciclo conhecido (<= 0 se desconhecido); só serve para parar mais cedo.
+/// @param converged Se não for nulo, recebe true se o método convergiu antes de max_iterations.
+/// @return Melhor limite inferior encontrado.
+double Graph::heldKarpBound(int max_iterations, double upper_bound, bool* converged) const {
+    int n = vertices.size();
+    if (converged) *converged = true;
+    if (n < 2) return 0.0;
+    if (n == 2) return travelCost(0, 1) + travelCost(1, 0);
+
+    std::vector<double> dist = buildDistanceMatrix();
+
+    // reference tour for the step size: nearest neighbour from vertex 0, improved with 2-opt
+    std::vector<int> tour = nearestNeighbourOnMatrix(dist, n, 0);
+    double reference = twoOptOnMatrix(tour, dist, HELD_KARP_NEIGHBOURS, 0.0);
+    double target = upper_bound > 0.0 ? std::min(upper_bound, reference) : reference;
+
+    std::vector<double> pi(n, 0.0);
+    std::vector<int> degree(n, 0);
+    double best = -std::numeric_limits<double>::max();
+    double lambda = 2.0;
+    int no_improvement = 0;
+    int it = 0;
+    bool done = false;
+
+    for (; it < max_iterations && !done; it++) {
+        double bound = oneTree(dist, pi, degree);
+
+        if (bound > best + 1e-9) {
+            best = bound;
+            no_improvement = 0;
+        } else if (++no_improvement >= HELD_KARP_PERIOD) {
+            lambda /= 2.0;
+            no_improvement = 0;
+        }
+
+        double norm = 0.0;
+        for (int v = 0; v < n; v++) {
+            norm += (double)(degree[v] - 2) * (degree[v] - 2);
+        }
+        // every vertex has degree 2 (the 1-tree is a tour), the bound reached a known tour, or the step vanished
+        done = norm == 0.0 || best >= target - 1e-9 || lambda < HELD_KARP_MIN_STEP;
+        if (done) break;
+
+        double step = lambda * (reference - bound) / norm;
+        for (int v = 0; v < n; v++) {
+            pi[v] += step * (degree[v] - 2);
+        }
+    }
+
+    if (converged) *converged = done;
+    return std::max(best, 0.0);
+}
@@ -3,8 +3,14 @@
 #include "utils/graph.h"
 #include "manager.h"
 #include "menu/menu.h"
+#include "menu/cli.h"
+
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        CommandLine cli(argc, argv);
+        return cli.run();
+    }
 
-int main() {
     Menu menu = Menu();
     menu.menuLoop();
 
@@ -7,7 +7,7 @@
 Manager::Manager(const char *nodes_file, const char *edges_file) : 
     nodes_reader(nodes_file),
     edges_reader(edges_file),
-    delivery_graph(true) {}
+    delivery_graph(std::make_shared<const Graph>(true)) {}
 
 /// @brief Constrói um objeto Manager.
 /// Responsável por gerenciar e chamar as funções que aplicam os algoritmos aos grafos.
@@ -15,142 +15,1403 @@ Manager::Manager(const char *nodes_file, const char *edges_file) :
 Manager::Manager(const char *f_name) : 
     edges_reader(f_name),
     nodes_reader(f_name),
-    delivery_graph(true) {}
+    delivery_graph(std::make_shared<const Graph>(true)) {}
+
+/// @brief Constrói um objeto Manager sobre um grafo já carregado (por exemplo, pelo GraphRegistry).
+/// O Manager lê o grafo partilhado sem o copiar; só reorder_vertices, que renumera os vértices, passa a trabalhar
+/// sobre uma cópia privada. A instanciação especializada só é construída quando um algoritmo a usar.
+/// @param graph Grafo carregado.
+Manager::Manager(std::shared_ptr<const Graph> graph) :
+    nodes_reader(""),
+    edges_reader(""),
+    delivery_graph(std::move(graph)) {}
 
 /// @brief Inicializa os grafos.
 /// Deve ser chamada caso o arquivo de nós e o arquivo de arestas estejam em arquivos separados.
 void Manager::initialize_graphs_with_2_files(){
-    std::vector<std::string> line;
+    MemPhase load_phase("load");
+    std::shared_ptr<Graph> graph = std::make_shared<Graph>(true);
+    GraphRegistry::readTwoFiles(nodes_reader, edges_reader, *graph);
+    delivery_graph = graph;
+    load_phase.end();
 
-    while(!nodes_reader.is_eof() && !nodes_reader.is_error()){
-        line = nodes_reader.read_line();
-        if(line.size() == 3){
-            delivery_graph.addVertex(std::stoi(line[0]), std::stod(line[1]), std::stod(line[2]), "");
-        }
-    }
-
-    while(!edges_reader.is_eof() && !edges_reader.is_error()){
-        line = edges_reader.read_line();
-        if(line.size() == 3){
-            delivery_graph.addEdge(std::stoi(line[0]), std::stoi(line[1]), std::stod(line[2]));
-        }
-    }
+    get_static_graph();
 }
 
 /// @brief Inicializa os grafos.
 /// Deve ser chamada caso o arquivo de nós e o arquivo de arestas estejam em um mesmo arquivo.
 void Manager::initialize_graphs_with_1_file(){
-    std::vector<std::string> line;
-
-    while(!edges_reader.is_eof() && !edges_reader.is_error()){
-        line = edges_reader.read_line();
-        bool can_add_edge = false;
-
-        if(line.size() == 5) {
-            //se a origem não existe, adiciono
-            if (!delivery_graph.vertexExists(std::stoi(line[0]))) {
-                delivery_graph.addVertex(std::stoi(line[0]), 0, 0, line[3]);
-                //se o destino não existe, adiciono
-                if (!delivery_graph.vertexExists(std::stoi(line[1]))) {
-                    delivery_graph.addVertex(std::stoi(line[1]), 0, 0, line[4]);
-                    can_add_edge = true;
-                } else can_add_edge = true;
-                //Se o destino não existe mas a origem existe, adiciono o destino
-            } else if (!delivery_graph.vertexExists(std::stoi(line[1]))) {
-                delivery_graph.addVertex(std::stoi(line[1]), 0, 0, line[4]);
-                can_add_edge = true;
-            } else can_add_edge = true;
-            //Se os dois vertices existem, adiciono a aresta
-            if (can_add_edge) {
-                delivery_graph.addEdge(std::stoi(line[0]), std::stoi(line[1]), std::stod(line[2]));
-            }
-        }
-        else if(line.size() == 3){
-            //se a origem nao existe, adiciona a origem
-            if(!delivery_graph.vertexExists(std::stoi(line[0]))){
-                delivery_graph.addVertex(std::stoi(line[0]), 0, 0, "");
-                //se o destino nao existe, adiciona o destino
-                if(!delivery_graph.vertexExists(std::stoi(line[1]))){
-                    delivery_graph.addVertex(std::stoi(line[1]), 0, 0, "");
-                    can_add_edge = true;
-                }
-                else can_add_edge = true;
-            }
-            //se o destino nao existe, mas a origem existe, adiciona o destino
-            else if(!delivery_graph.vertexExists(std::stoi(line[1]))){
-                delivery_graph.addVertex(std::stoi(line[1]), 0, 0, "");
-                can_add_edge = true;
-            }
-            else can_add_edge = true;
+    MemPhase load_phase("load");
+    std::shared_ptr<Graph> graph = std::make_shared<Graph>(true);
+    GraphRegistry::readOneFile(edges_reader, *graph);
+    delivery_graph = graph;
+    load_phase.end();
 
-            if(can_add_edge){
-                delivery_graph.addEdge(std::stoi(line[0]), std::stoi(line[1]), std::stod(line[2]));
-            }
-        }
-    }
+    get_static_graph();
 }
 
-/// @brief Corre o algoritmo de Backtracking.
+/// @brief Corre o algoritmo de Backtracking, com cortes de branch-and-bound.
+/// Antes da pesquisa o grafo é pré-processado (Graph::preprocess): se não puder ter ciclo hamiltoniano a pesquisa não
+/// chega a correr, caso contrário corre sobre uma cópia reduzida (sem as arestas dominadas).
+/// A pesquisa (ExactSearch) usa todas as threads disponíveis. Se estiver definido um ficheiro de checkpoint
+/// (set_checkpoint), o estado é guardado periodicamente e, se o ficheiro já existir e for deste grafo, a pesquisa
+/// continua de onde ficou, mesmo que tenha sido interrompida noutra máquina ou com outro número de threads.
+/// Se estiver definido um limiar de gap, a pesquisa termina assim que o melhor ciclo estiver a essa distância do limite de Held-Karp.
 /// Imprime também o custo e o tempo de execução do algoritmo.
 void Manager::backtrack_tsp(){
     clock_t start = clock();
+    MemPhase phase("solve");
 
-    double min_cost = std::numeric_limits<double>::max();
-    std::vector<int> path = {0}; // Start from vertex 0
-    std::vector<bool> visited(delivery_graph.getNumVertices(), false);
-    visited[0] = true; // Mark the starting vertex as visited
+    Graph reduced = *delivery_graph;
+    PreprocessReport report = reduced.preprocess();
+    print_preprocess_report(report);
+    if(!report.feasible){
+        std::cout << "No Hamiltonian cycle: " << report.reason << std::endl;
+        return;
+    }
 
-    // Call the recursive function to find the minimum cost Hamiltonian cycle
-    delivery_graph.tsp_backtrack(path, visited, min_cost, 0.0);
+    ExactSearchParams params;
+    params.threads = std::max(1u, std::thread::hardware_concurrency());
+    params.lower_bound = gap_threshold > 0 ? get_lower_bound() : lower_bound;
+    params.gap_threshold = gap_threshold;
+    params.checkpoint_file = checkpoint_file;
+    params.checkpoint_interval = checkpoint_interval;
+    ExactSearch search(reduced, params);
+
+    SearchCheckpoint state = search.initialState();
+    if(!checkpoint_file.empty()){
+        SearchCheckpoint saved;
+        if(!saved.load(checkpoint_file)){
+            std::cout << "Checkpoint: starting a new search (" << checkpoint_file << " not found or unreadable)" << std::endl;
+        }
+        else if(saved.fingerprint != state.fingerprint){
+            std::cout << "Checkpoint: " << checkpoint_file << " belongs to another graph, starting a new search" << std::endl;
+        }
+        else{
+            std::cout << "Checkpoint: resuming from " << checkpoint_file << " (" << saved.frontier.size() << " open prefix(es), "
+                      << saved.expanded_nodes << " nodes, " << saved.seconds << " seconds so far)" << std::endl;
+            state = std::move(saved);
+        }
+    }
+
+    ExactSearchResult result = search.run(std::move(state));
 
     clock_t end = clock();
 
-    std::cout << "Minimum Distance: " << min_cost << std::endl;
+    std::cout << "Minimum Distance: " << (result.path.empty() ? std::numeric_limits<double>::max() : result.cost) << std::endl;
     std::cout << "Execution Time: " << double(end - start) / CLOCKS_PER_SEC << " seconds" << std::endl;
+    std::cout << "Expanded Nodes: " << result.expanded_nodes << (result.gap_reached ? " (stopped at gap threshold)" : "") << std::endl;
+    std::cout << "Threads: " << params.threads << std::endl;
+    if(!checkpoint_file.empty()){
+        std::cout << "Search Time (all runs): " << result.seconds << " seconds" << std::endl;
+        std::cout << "Checkpoints: " << result.checkpoints << " written in " << result.checkpoint_seconds << " seconds";
+        if(result.complete || result.gap_reached) std::cout << ", " << checkpoint_file << " removed (search finished)";
+        std::cout << std::endl;
+    }
+    if (!result.path.empty()) print_gap(result.cost);
+}
+
+/// @brief Imprime o relatório do pré-processamento.
+/// @param report Relatório devolvido por Graph::preprocess.
+void Manager::print_preprocess_report(const PreprocessReport& report){
+    std::cout << "Preprocessing: " << report.components << " component(s), "
+              << report.articulation_points.size() << " articulation point(s), "
+              << report.low_degree_vertices.size() << " vertex(es) with degree < 2, "
+              << report.forced_edges.size() << " forced edge(s), "
+              << report.removed_edges << " dominated edge(s) removed" << std::endl;
+    std::cout << "Preprocessing Time: " << report.seconds << " seconds" << std::endl;
+}
+
+/// @brief Devolve a instanciação especializada do grafo (StaticGraph), construindo-a na fase "build" na primeira vez que
+/// é pedida. Um Manager criado sobre um grafo partilhado não a constrói enquanto nenhum algoritmo precisar dela.
+/// @return Instanciação especializada do grafo atual.
+const AnyStaticGraph& Manager::get_static_graph(){
+    if(std::holds_alternative<std::monostate>(static_graph)){
+        MemPhase phase("build");
+        static_graph = makeStaticGraph(*delivery_graph);
+    }
+    return static_graph;
+}
+
+/// @brief Calcula o custo de um caminho, na fase "evaluate".
+/// @param path Vetor de inteiros, representando o caminho.
+/// @return Distância total do caminho.
+double Manager::evaluate(const std::vector<int>& path){
+    MemPhase phase("evaluate");
+    return delivery_graph->calculateTotalDistance(path);
+}
 
+/// @brief Ativa ou desativa a instrumentação de memória (alocações por fase, RSS e tamanho das estruturas).
+/// @param enabled True para ativar.
+void Manager::set_memory_tracking(bool enabled){
+    MemStats::clearPhases();
+    MemStats::enable(enabled);
+}
+
+/// @brief Imprime as alocações de cada fase desde o último relatório, o RSS do processo e o tamanho das estruturas.
+/// Não faz nada se a instrumentação de memória não estiver ativa.
+void Manager::print_memory_report(){
+    if(!MemStats::isEnabled()) return;
+
+    MemStats::printReport(std::cout);
+    MemStats::clearPhases();
+    std::cout << "Structure [graph]: " << delivery_graph->memoryFootprint() << " bytes" << std::endl;
+    withStaticGraph(static_graph, [](const auto& g){
+        std::cout << "Structure [" << g.describe() << "]: " << g.memoryFootprint() << " bytes" << std::endl;
+    });
 }
 
 /// @brief Imprime o grafo.
 void Manager::printGraph(){
-    delivery_graph.printGraph();
+    delivery_graph->printGraph();
 }
 
 /// @brief Devolve a aproximação triangular do grafo.
+/// A MST é a de mst_parent (Prim vetorizado com a matriz densa da instanciação especializada, Prim com fila de
+/// prioridade nos outros armazenamentos), a mesma do portefólio. A DFS e o custo são os de Graph::triangularApproximation.
 /// Imprime também o custo e o tempo de execução do algoritmo.
 void Manager::triangularApproximation() {
     clock_t start = clock();
 
-    double ans = delivery_graph.triangularApproximation();
+    double ans;
+    {
+        MemPhase phase("solve");
+        get_static_graph();
+        ans = delivery_graph->triangularApproximation(mst_parent());
+    }
 
     clock_t end = clock();
 
     std::cout << "Minimum Distance: " << ans << std::endl;
     std::cout << "Execution Time: " << double(end - start) / CLOCKS_PER_SEC << " seconds" << std::endl;
+    print_gap(ans);
+}
+
+/// @brief MST do grafo enraizada no vértice 0, partilhada pela aproximação triangular e pelo portefólio: Prim sobre a
+/// instanciação especializada (mstParentT, vetorizado com matriz densa) ou, se ainda não houver nenhuma, o Prim do
+/// grafo (Graph::primMST). Só lê o grafo e a instanciação já construída, pelo que pode correr na thread de um solver.
+/// @return Pai de cada vértice na MST (-1 na raiz e nos vértices fora da árvore).
+std::vector<int> Manager::mst_parent() const{
+    std::vector<int> parent;
+    bool built = withStaticGraph(static_graph, [&](const auto& g){
+        parent = mstParentT(g);
+    });
+    if(!built){
+        parent.assign(delivery_graph->getNumVertices(), -1);
+        delivery_graph->primMST(parent);
+    }
+    return parent;
 }
 
 /// @brief Corre o algoritmo nearest neighbor para diferentes starting vertex.
+/// Corre sobre a instanciação especializada do grafo (StaticGraph), escolhida depois de carregar os ficheiros.
+/// Em grafos com mais de NEAREST_NEIGHBOR_ALL_STARTS vértices só são testados NEAREST_NEIGHBOR_LARGE_STARTS vértices iniciais.
 /// Este algoritmo tem complexidade 0(V²) em que V é o número de vértices do grafo.
+/// Se estiver definido um limiar de gap, deixa de testar novos vértices iniciais assim que o melhor caminho o atingir.
 /// Imprime também o custo e o tempo de execução do algoritmo.
 void Manager::nearest_neighbor(){
 
     clock_t start = clock();
 
-    std::unordered_map<int, vertexNode> vertices_original_graph = delivery_graph.getVertices();
     double min_cost = std::numeric_limits<double>::max();
     std::vector<int> min_path;
-    for(int i = 0; i < vertices_original_graph.size(); i++){
-        std::vector<int> path = delivery_graph.nearestNeighbour(i);
-        double result = delivery_graph.calculateTotalDistance(path);
-        if(result < min_cost){
-            min_cost = result;
-            min_path = path;
-        }
+    std::string storage;
+    {
+        MemPhase phase("solve");
+        withStaticGraph(get_static_graph(), [&](const auto& g){
+            storage = g.describe();
+            int n = g.getNumVertices();
+            int starts = n <= NEAREST_NEIGHBOR_ALL_STARTS ? n : NEAREST_NEIGHBOR_LARGE_STARTS;
+            for(int s = 0; s < starts; s++){
+                std::vector<int> path = nearestNeighbourT(g, (int)((long long)s * n / starts));
+                double result = tourCostT(g, path);
+                if(result < min_cost){
+                    min_cost = result;
+                    min_path = path;
+                    if(gap_reached(min_cost)) break;
+                }
+            }
+        });
+    }
+    if(min_path.empty()){
+        std::cout << "The graph is empty" << std::endl;
+        return;
     }
-    double result = delivery_graph.calculateTotalDistance(min_path);
+    double result = evaluate(min_path);
 
     clock_t end = clock();
 
     std::cout << "Minimum Distance: " << result << std::endl;
     std::cout << "Execution Time: " << double(end - start) / CLOCKS_PER_SEC << " seconds" << std::endl;
+    std::cout << "Storage: " << storage << std::endl;
+    print_gap(result);
+}
+
+/// @brief Constrói um ciclo pela ordem da curva de Hilbert sobre as coordenadas (Graph::spaceFillingCurveTour).
+/// Pensado para dar um ciclo em milissegundos em grafos reais muito grandes, por exemplo para alimentar outros solvers.
+/// Este algoritmo tem complexidade O(V log V) e só consulta distâncias para avaliar o ciclo.
+/// Imprime também o custo, o tempo de construção e o tempo total (com a avaliação).
+void Manager::space_filling_curve(){
+    if(!delivery_graph->hasCoordinates()){
+        std::cout << "The space-filling curve heuristic needs vertex coordinates" << std::endl;
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> path;
+    {
+        MemPhase phase("solve");
+        path = delivery_graph->spaceFillingCurveTour(num_threads);
+    }
+    auto built = std::chrono::steady_clock::now();
+    double result = evaluate(path);
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "Minimum Distance: " << result << std::endl;
+    std::cout << "Construction Time: " << std::chrono::duration<double>(built - start).count() << " seconds" << std::endl;
+    std::cout << "Execution Time: " << std::chrono::duration<double>(end - start).count() << " seconds" << std::endl;
+    std::cout << "Threads: " << num_threads << std::endl;
+    print_gap(result);
+}
+
+/// @brief Corre o solver de divisão e conquista, pensado para os grafos reais de maior dimensão.
+/// Os clusters são resolvidos em paralelo, usando todas as threads disponíveis.
+/// Imprime também o custo e o tempo de execução do algoritmo.
+void Manager::clustered_tour(){
+    auto start = std::chrono::steady_clock::now();
+
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> path;
+    {
+        MemPhase phase("solve");
+        path = delivery_graph->clusteredTour(CLUSTER_SIZE, num_threads);
+    }
+    double result = evaluate(path);
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "Minimum Distance: " << result << std::endl;
+    std::cout << "Execution Time: " << std::chrono::duration<double>(end - start).count() << " seconds" << std::endl;
+    std::cout << "Threads: " << num_threads << std::endl;
+    print_gap(result);
+}
+
+/// @brief Constrói um ciclo pelo vizinho mais próximo a partir do vértice 0 e melhora-o com 2-opt.
+/// Se o vizinho mais próximo ficar sem vizinhos por visitar, os vértices em falta são acrescentados por ordem.
+/// Se estiver definido um limiar de gap, a pesquisa local para assim que o atingir.
+/// Num grafo incompleto sem coordenadas os pares sem aresta custariam 0, pelo que o ciclo é construído e melhorado
+/// sobre a closure métrica (vizinho mais próximo da closure e 2-opt sobre a sua matriz) e é impresso o percurso real.
+/// Imprime também o custo e o tempo de execução do algoritmo.
+void Manager::two_opt(){
+    auto start = std::chrono::steady_clock::now();
+
+    int n = delivery_graph->getNumVertices();
+    // without coordinates a missing edge would cost 0, so incomplete graphs are searched on shortest-path distances
+    GraphProfile profile = delivery_graph->profile(0, 1);
+    if(!profile.complete && !profile.coordinates){
+        if(n > DENSE_MATRIX_VERTICES){
+            std::cout << "Graph is incomplete and has no coordinates; the metric closure matrix of " << n
+                      << " vertices is too large for 2-opt (use the closure nearest neighbour)" << std::endl;
+            return;
+        }
+        int num_threads = std::max(1u, std::thread::hardware_concurrency());
+        MetricClosure closure(*delivery_graph, METRIC_CLOSURE_MEMORY);
+        std::vector<int> path;
+        std::vector<double> dist;
+        double initial;
+        {
+            MemPhase phase("solve");
+            if(!closure_tour(closure, num_threads, path, dist)) return;
+            initial = delivery_graph->closureTourCost(path, closure);
+            Graph::twoOptOnMatrix(path, dist, TWO_OPT_NEIGHBOURS, 0.0);
+        }
+        double result = delivery_graph->closureTourCost(path, closure);
+        std::vector<int> route = delivery_graph->expandTour(path, closure);
+
+        auto end = std::chrono::steady_clock::now();
+
+        std::cout << "Graph is incomplete and has no coordinates: costs are shortest-path distances (metric closure)" << std::endl;
+        std::cout << "Initial Distance: " << initial << std::endl;
+        std::cout << "Minimum Distance: " << result << std::endl;
+        std::cout << "Execution Time: " << std::chrono::duration<double>(end - start).count() << " seconds" << std::endl;
+        print_route(route);
+        return;
+    }
+
+    std::vector<int> path;
+    double initial;
+    std::string representation;
+    {
+        MemPhase phase("solve");
+        path = delivery_graph->nearestNeighbour(0);
+        std::vector<bool> in_path(n, false);
+        for(int v : path) in_path[v] = true;
+        for(int v = 0; v < n; v++){
+            if(!in_path[v]) path.push_back(v);
+        }
+        initial = delivery_graph->calculateTotalDistance(path);
+
+        double target = 0.0;
+        if(gap_threshold > 0.0){
+            target = get_lower_bound() * (1.0 + gap_threshold);
+        }
+        representation = delivery_graph->twoOpt(path, TWO_OPT_NEIGHBOURS, target);
+    }
+    double result = evaluate(path);
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "Initial Distance: " << initial << std::endl;
+    std::cout << "Minimum Distance: " << result << std::endl;
+    std::cout << "Execution Time: " << std::chrono::duration<double>(end - start).count() << " seconds" << std::endl;
+    std::cout << "Tour Representation: " << representation << std::endl;
+    print_gap(result);
+}
+
+/// @brief Constrói um ciclo com a heurística greedy edge (Graph::greedyEdgeTour).
+/// Com todas as arestas, as candidatas são as arestas do grafo; num grafo só com coordenadas isso são todos os pares,
+/// pelo que acima de DENSE_MATRIX_VERTICES vértices são usados os GREEDY_EDGE_NEIGHBOURS vizinhos mais próximos.
+/// Imprime também o custo e o tempo de execução do algoritmo.
+/// @param all_edges True para usar todas as arestas, false para usar os GREEDY_EDGE_NEIGHBOURS vizinhos mais próximos.
+void Manager::greedy_edge(bool all_edges){
+    auto start = std::chrono::steady_clock::now();
+
+    int n = delivery_graph->getNumVertices();
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    if(all_edges && delivery_graph->getNumEdges() == 0 && n > DENSE_MATRIX_VERTICES){
+        std::cout << "Too many vertex pairs for the full edge list, using " << GREEDY_EDGE_NEIGHBOURS << " nearest neighbours" << std::endl;
+        all_edges = false;
+    }
+
+    std::vector<int> path;
+    {
+        MemPhase phase("solve");
+        path = delivery_graph->greedyEdgeTour(all_edges ? 0 : GREEDY_EDGE_NEIGHBOURS, num_threads);
+    }
+    if(path.empty()){
+        std::cout << "The graph is empty" << std::endl;
+        return;
+    }
+    double result = evaluate(path);
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "Minimum Distance: " << result << std::endl;
+    std::cout << "Execution Time: " << std::chrono::duration<double>(end - start).count() << " seconds" << std::endl;
+    std::cout << "Candidate Edges: " << (all_edges ? "all edges" : std::to_string(GREEDY_EDGE_NEIGHBOURS) + " nearest neighbours") << std::endl;
+    print_gap(result);
+}
+
+/// @brief Corre o vizinho mais próximo sobre a closure métrica do grafo (caminhos mais curtos em vez de arestas diretas).
+/// As linhas da closure são calculadas com Dijkstra à medida que são precisas: cada passo só lê a linha do vértice
+/// atual, que não é conhecido antes do passo anterior, pelo que não há linhas que valha a pena pré-calcular.
+/// Imprime também o percurso real, com os vértices intermédios.
+/// Imprime também o custo e o tempo de execução do algoritmo.
+void Manager::nearest_neighbor_closure(){
+    auto start = std::chrono::steady_clock::now();
+    MemPhase phase("solve");
+
+    int n = delivery_graph->getNumVertices();
+    MetricClosure closure(*delivery_graph, METRIC_CLOSURE_MEMORY);
+
+    std::vector<int> path = delivery_graph->nearestNeighbourClosure(0, closure);
+    double result = delivery_graph->closureTourCost(path, closure);
+    std::vector<int> route = delivery_graph->expandTour(path, closure);
+
+    auto end = std::chrono::steady_clock::now();
+
+    if((int)path.size() < n){
+        std::cout << "Graph is disconnected: only " << path.size() << " of " << n << " vertices were reached" << std::endl;
+    }
+    std::cout << "Minimum Distance: " << result << std::endl;
+    std::cout << "Execution Time: " << std::chrono::duration<double>(end - start).count() << " seconds" << std::endl;
+    print_route(route);
+    std::cout << "Closure Rows: " << closure.getMisses() << " computed, " << closure.getHits() << " cache hits, "
+              << closure.getEvictions() << " evictions" << std::endl;
+    if(MemStats::isEnabled()){
+        std::cout << "Structure [metric closure]: " << closure.memoryFootprint() << " bytes" << std::endl;
+    }
+}
+
+/// @brief Calcula e imprime o limite inferior de Held-Karp (1-tree com otimização subgradiente).
+/// O limite fica guardado e é usado para reportar o gap de qualquer caminho calculado a seguir.
+/// Este algoritmo tem complexidade O(I * V²) em que I é o número de iterações e V o número de vértices do grafo.
+void Manager::held_karp_bound(){
+    clock_t start = clock();
+    MemPhase phase("solve");
+
+    lower_bound = 0.0;
+    double bound = get_lower_bound();
+
+    clock_t end = clock();
+
+    std::cout << "Lower Bound: " << bound << std::endl;
+    std::cout << "Converged: " << (lower_bound_converged ? "yes" : "no (iteration limit reached)") << std::endl;
+    std::cout << "Execution Time: " << double(end - start) / CLOCKS_PER_SEC << " seconds" << std::endl;
+}
+
+/// @brief Corre em simultâneo, cada um na sua thread, o backtracking (branch-and-bound), a aproximação triangular e o
+/// vizinho mais próximo (todos os vértices iniciais) sobre o mesmo grafo, só de leitura.
+/// O melhor ciclo é partilhado: o branch-and-bound corta com ele e os solvers param quando o branch-and-bound prova a
+/// otimalidade, quando o custo fica dentro do gap pedido ou igual ao limite inferior (se já tiver sido calculado), ou
+/// quando passa o prazo (set_time_limit). Em grafos incompletos as heurísticas só propõem ciclos que usem arestas do
+/// grafo, para que a prova do branch-and-bound continue válida; em grafos só com coordenadas não há backtracking.
+/// Imprime o solver vencedor, quando encontrou o melhor ciclo, o motivo de paragem e o resumo de cada solver.
+void Manager::portfolio(){
+    int n = delivery_graph->getNumVertices();
+    if(n == 0){
+        std::cout << "The graph is empty" << std::endl;
+        return;
+    }
+    MemPhase phase("solve");
+
+    double target = lower_bound > 0.0 && gap_threshold > 0.0 ? lower_bound * (1.0 + gap_threshold) : 0.0;
+    Portfolio race(time_limit, target, lower_bound);
+    const Graph& graph = *delivery_graph;
+    // built here so that the solver threads only read it
+    get_static_graph();
+
+    bool complete = true;
+    for(int v = 0; v < n && complete; v++){
+        complete = (int)graph.getAdjacent(v).size() >= n - 1;
+    }
+    bool has_edges = graph.getNumEdges() > 0;
+    auto is_cycle = [&graph, complete, has_edges](const std::vector<int>& path){
+        if(complete || !has_edges) return true;
+        for(size_t i = 0; i < path.size(); i++){
+            int u = path[i], v = path[(i + 1) % path.size()];
+            const std::vector<edgeNode>& adj = graph.getAdjacent(u);
+            if(std::none_of(adj.begin(), adj.end(), [v](const edgeNode& e){ return e.vertex == v; })) return false;
+        }
+        return true;
+    };
+
+    std::vector<double> min_out = delivery_graph->cheapestOutgoingEdges();
+    std::vector<double> weights = n <= DENSE_MATRIX_VERTICES ? delivery_graph->edgeWeightMatrix() : std::vector<double>();
+    if(has_edges){
+        race.add("backtracking", [&graph, &min_out, &weights, n](Portfolio& p, const std::string& name){
+            std::vector<int> path = {0};
+            std::vector<bool> visited(n, false);
+            visited[0] = true;
+
+            SearchBound bound;
+            bound.lower_bound = 0.0;
+            bound.gap_threshold = 0.0;
+            bound.min_out = min_out;
+            bound.weights = weights.empty() ? nullptr : &weights;
+            bound.remaining_min_out = 0.0;
+            bound.expanded_nodes = 0;
+            bound.stop = false;
+            bound.cancel = &p.stopFlag();
+            bound.shared_cost = &p.bestCost();
+            bound.on_improvement = [&](double cost, const std::vector<int>& tour){ p.offer(name, cost, tour); };
+            for(int v = 1; v < n; v++) bound.remaining_min_out += min_out[v];
+
+            double min_cost = std::numeric_limits<double>::max();
+            graph.tsp_branch_and_bound(path, visited, min_cost, 0.0, bound);
+            if(!bound.stop) p.proveOptimal(name);
+        });
+    }
+
+    // the same tour as the triangular approximation command
+    race.add("triangular", [this, &graph, n, &is_cycle](Portfolio& p, const std::string& name){
+        std::vector<int> path = graph.mstPreorder(mst_parent());
+        if((int)path.size() == n && is_cycle(path)) p.offer(name, graph.calculateTotalDistance(path), path);
+    });
+
+    race.add("nearest-neighbor", [this, n, &is_cycle](Portfolio& p, const std::string& name){
+        withStaticGraph(static_graph, [&](const auto& g){
+            for(int s = 0; s < n && !p.stopped(); s++){
+                std::vector<int> path = nearestNeighbourT(g, s);
+                if((int)path.size() == n && is_cycle(path)) p.offer(name, tourCostT(g, path), path);
+            }
+        });
+    });
+
+    PortfolioResult result = race.run();
+    phase.end();
+
+    for(const SolverReport& report : result.solvers){
+        std::cout << "Solver [" << report.name << "]: ";
+        if(report.best_cost == std::numeric_limits<double>::infinity()) std::cout << "no tour";
+        else std::cout << "best " << report.best_cost;
+        std::cout << ", " << (report.finished ? "finished" : "stopped") << " after " << report.seconds << " seconds" << std::endl;
+    }
+    std::cout << "Stop Reason: " << result.stop_reason << std::endl;
+    if(result.path.empty()){
+        std::cout << "No solver found a Hamiltonian cycle" << std::endl;
+        return;
+    }
+    double cost = evaluate(result.path);
+    std::cout << "Winner: " << result.winner << " (found after " << result.found_at << " seconds)" << std::endl;
+    std::cout << "Minimum Distance: " << cost << (result.optimal ? " (optimal)" : "") << std::endl;
+    std::cout << "Execution Time: " << result.seconds << " seconds" << std::endl;
+    print_gap(cost);
+}
+
+/// @brief Corre o MAX-MIN Ant System (AntColony), pensado para os grafos completos de 200 a 700 vértices.
+/// As formigas constroem ciclos em paralelo, usando todas as threads disponíveis, até ANT_COLONY_ITERATIONS iterações
+/// ou até ao prazo definido com set_time_limit. Só corre em grafos até DENSE_MATRIX_VERTICES vértices, porque usa a
+/// matriz de distâncias completa.
+/// Num grafo incompleto sem coordenadas os pares sem aresta custariam 0, pelo que as formigas usam a matriz da closure
+/// métrica (partindo do vizinho mais próximo da closure) e é impresso o percurso real.
+/// Imprime também o custo, o tempo de execução e o número de ciclos construídos por segundo.
+/// @param local_search True para melhorar com 2-opt a melhor formiga de cada iteração.
+void Manager::ant_colony(bool local_search){
+    int n = delivery_graph->getNumVertices();
+    if(n < 3 || n > DENSE_MATRIX_VERTICES){
+        std::cout << "The ant colony needs between 3 and " << DENSE_MATRIX_VERTICES << " vertices" << std::endl;
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    // without coordinates a missing edge would cost 0, so incomplete graphs are searched on shortest-path distances
+    GraphProfile profile = delivery_graph->profile(0, 1);
+    bool use_closure = !profile.complete && !profile.coordinates;
+    std::unique_ptr<MetricClosure> closure;
+    if(use_closure) closure = std::make_unique<MetricClosure>(*delivery_graph, METRIC_CLOSURE_MEMORY);
+
+    AntColonyParams params;
+    params.ants = ANT_COLONY_ANTS;
+    params.max_iterations = ANT_COLONY_ITERATIONS;
+    params.max_seconds = time_limit;
+    params.local_search = local_search;
+    params.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    AntColonyResult result;
+    size_t footprint;
+    {
+        MemPhase phase("solve");
+        std::vector<double> dist;
+        std::vector<int> initial;
+        if(use_closure){
+            if(!closure_tour(*closure, params.threads, initial, dist)) return;
+        }
+        else{
+            dist = delivery_graph->buildDistanceMatrix();
+            initial = delivery_graph->nearestNeighbour(0);
+            std::vector<bool> in_path(n, false);
+            for(int v : initial) in_path[v] = true;
+            for(int v = 0; v < n; v++){
+                if(!in_path[v]) initial.push_back(v);
+            }
+        }
+
+        AntColony colony(dist, n, params);
+        result = colony.run(initial);
+        footprint = colony.memoryFootprint() + dist.capacity() * sizeof(double);
+    }
+    double cost = use_closure ? delivery_graph->closureTourCost(result.path, *closure) : evaluate(result.path);
+
+    auto end = std::chrono::steady_clock::now();
+
+    if(use_closure){
+        std::cout << "Graph is incomplete and has no coordinates: costs are shortest-path distances (metric closure)" << std::endl;
+    }
+    std::cout << "Minimum Distance: " << cost << std::endl;
+    std::cout << "Execution Time: " << std::chrono::duration<double>(end - start).count() << " seconds" << std::endl;
+    std::cout << "Iterations: " << result.iterations << " (best tour found at iteration " << result.best_iteration << ")" << std::endl;
+    std::cout << "Tours: " << result.tours << " (" << result.tours / std::max(result.seconds, 1e-9) << " tours/second)" << std::endl;
+    std::cout << "Threads: " << params.threads << std::endl;
+    if(use_closure) print_route(delivery_graph->expandTour(result.path, *closure));
+    if(MemStats::isEnabled()){
+        std::cout << "Structure [ant colony]: " << footprint << " bytes" << std::endl;
+    }
+    print_gap(cost);
+}
+
+/// @brief Modo automático: calcula um perfil rápido do grafo (Graph::profile) e, a partir dele e do prazo definido
+/// com set_time_limit, escolhe o pipeline mais rápido que serve o grafo:
+/// - até AUTO_EXACT_VERTICES vértices com arestas, um ciclo greedy edge seguido da pesquisa exata (ExactSearch), que
+///   prova a otimalidade ou, se o prazo acabar, devolve o melhor ciclo encontrado;
+/// - até DENSE_MATRIX_VERTICES vértices, construção e 2-opt sobre a matriz de distâncias, refinados pela colónia de
+///   formigas com o tempo que sobrar; em grafos incompletos sem coordenadas a matriz é a da closure métrica e o ciclo
+///   segue caminhos mais curtos;
+/// - acima disso, a divisão em clusters se couber no prazo e os custos seguirem as coordenadas, a curva de Hilbert se
+///   não couber, greedy edge sem coordenadas ou com custos não métricos, e o vizinho mais próximo sobre caminhos mais
+///   curtos em grafos incompletos sem coordenadas.
+/// Imprime o perfil, o plano e as razões da escolha, e depois o resultado de cada etapa.
+void Manager::auto_solve(){
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&start](){ return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+
+    int n = delivery_graph->getNumVertices();
+    if(n == 0){
+        std::cout << "The graph is empty" << std::endl;
+        return;
+    }
+    double budget = time_limit > 0.0 ? time_limit : PORTFOLIO_SECONDS;
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    GraphProfile profile;
+    {
+        MemPhase phase("profile");
+        profile = delivery_graph->profile(AUTO_PROFILE_SAMPLES, num_threads);
+    }
+    bool metric = profile.violation_rate <= AUTO_METRIC_VIOLATION_RATE;
+    bool closure_costs = !profile.complete && !profile.coordinates;
+
+    std::cout << "Profile: " << n << " vertices, " << profile.edges << " edges (density " << profile.density
+              << (profile.complete ? ", complete" : "") << "), minimum degree " << profile.min_degree << ", "
+              << (profile.coordinates ? "with" : "no") << " coordinates" << std::endl;
+    std::cout << "Profile: " << profile.violations << " of " << profile.triangles << " sampled triangles violate the triangle inequality ("
+              << profile.violation_rate * 100.0 << "%), " << profile.threads << " thread(s), " << profile.seconds << " seconds" << std::endl;
+    std::cout << "Budget: " << budget << " seconds" << std::endl;
+
+    enum class Plan { Trivial, Exact, LocalSearch, Closure, Clustering, Curve, GreedyEdge };
+    Plan plan;
+    std::string pipeline;
+    std::vector<std::string> reasons;
+    std::ostringstream reason;
+    auto explain = [&reason, &reasons](){
+        reasons.push_back(reason.str());
+        reason.str("");
+    };
+
+    if(n < 3){
+        plan = Plan::Trivial;
+        pipeline = "nearest-neighbor";
+        reason << "fewer than 3 vertices: every order is the same tour";
+        explain();
+    }
+    else if(n <= AUTO_EXACT_VERTICES && profile.edges > 0){
+        plan = Plan::Exact;
+        pipeline = "greedy-edge -> branch-and-bound";
+        reason << n << " vertices (<= " << AUTO_EXACT_VERTICES << "): the exact search can prove optimality within the budget";
+        explain();
+        reason << "the greedy tour seeds the search's upper bound and is kept if the budget runs out";
+        explain();
+    }
+    else if(n <= DENSE_MATRIX_VERTICES){
+        plan = Plan::LocalSearch;
+        pipeline = closure_costs ? "closure-nn -> 2-opt" : "greedy-edge -> 2-opt";
+        if(n <= AUTO_EXACT_VERTICES) reason << "no edge list for the exact search";
+        else reason << n << " vertices: too many for the exact search (> " << AUTO_EXACT_VERTICES << ")";
+        reason << ", few enough (<= " << DENSE_MATRIX_VERTICES << ") for construction plus local search on a distance matrix";
+        explain();
+        if(closure_costs){
+            reason << "density " << profile.density << " without coordinates: pairs without an edge have no cost, so the matrix holds "
+                   << "shortest-path distances (metric closure) and the tour follows shortest paths";
+            explain();
+        }
+        if(budget >= AUTO_REFINE_SECONDS){
+            pipeline += " -> ant-colony-2opt";
+            reason << "the ant colony, seeded with the 2-opt tour, refines it with what is left of the budget";
+            explain();
+        }
+    }
+    else if(closure_costs){
+        plan = Plan::Closure;
+        pipeline = "closure-nn";
+        reason << n << " vertices (> " << DENSE_MATRIX_VERTICES << "), density " << profile.density << " without coordinates: "
+               << "pairs without an edge have no cost, so the tour follows shortest paths computed on demand";
+        explain();
+    }
+    else if(profile.coordinates && metric){
+        double estimate = n * AUTO_CLUSTER_SECONDS_PER_VERTEX;
+        if(estimate <= budget){
+            plan = Plan::Clustering;
+            pipeline = "clustering";
+            reason << n << " vertices (> " << DENSE_MATRIX_VERTICES << "): decomposition into clusters solved in parallel, estimated "
+                   << estimate << " seconds";
+        }
+        else{
+            plan = Plan::Curve;
+            pipeline = "space-filling-curve";
+            reason << n << " vertices: decomposition would take about " << estimate << " seconds, over the budget; the Hilbert curve is O(V log V)";
+        }
+        explain();
+    }
+    else{
+        plan = Plan::GreedyEdge;
+        pipeline = "greedy-edge";
+        reason << n << " vertices (> " << DENSE_MATRIX_VERTICES << ")";
+        if(profile.coordinates) reason << " with costs that break the triangle inequality, so a decomposition by coordinates would misjudge them";
+        else reason << " without coordinates to decompose by";
+        reason << "; greedy edge works on the costs themselves";
+        explain();
+    }
+    if(!metric && (plan == Plan::Exact || (plan == Plan::LocalSearch && !closure_costs))){
+        reason << profile.violation_rate * 100.0 << "% of sampled triangles violate the triangle inequality: the MST-based "
+               << "approximation has no guarantee here, local search and exact search do not rely on it";
+        explain();
+    }
+
+    std::cout << "Plan: " << pipeline << std::endl;
+    for(const std::string& line : reasons) std::cout << "Reason: " << line << std::endl;
+
+    switch(plan){
+        case Plan::Trivial: nearest_neighbor(); return;
+        case Plan::Closure: nearest_neighbor_closure(); return;
+        case Plan::Clustering: clustered_tour(); return;
+        case Plan::Curve: space_filling_curve(); return;
+        case Plan::GreedyEdge: greedy_edge(false); return;
+        default: break;
+    }
+
+    auto stage = [&elapsed](const std::string& name, double cost){
+        std::cout << "Stage [" << name << "]: " << cost << " after " << elapsed() << " seconds" << std::endl;
+    };
+
+    MemPhase phase("solve");
+    std::vector<int> path;
+    double cost;
+
+    if(plan == Plan::Exact){
+        path = delivery_graph->greedyEdgeTour(0, num_threads);
+        cost = delivery_graph->calculateTotalDistance(path);
+        stage("greedy-edge", cost);
+
+        Graph reduced = *delivery_graph;
+        PreprocessReport report = reduced.preprocess();
+        print_preprocess_report(report);
+        if(!report.feasible){
+            std::cout << "No Hamiltonian cycle: " << report.reason << std::endl;
+            return;
+        }
+
+        // the greedy joins may use pairs without an edge, which the search never follows
+        const Graph& graph = *delivery_graph;
+        bool is_cycle = (int)path.size() == n;
+        for(int i = 0; i < n && is_cycle; i++){
+            int u = path[i], v = path[(i + 1) % n];
+            const std::vector<edgeNode>& adj = graph.getAdjacent(u);
+            is_cycle = std::any_of(adj.begin(), adj.end(), [v](const edgeNode& e){ return e.vertex == v; });
+        }
+        if(!is_cycle) cost = std::numeric_limits<double>::infinity();
+
+        ExactSearchParams params;
+        params.threads = num_threads;
+        params.lower_bound = lower_bound;
+        params.gap_threshold = gap_threshold;
+        params.time_limit = std::max(budget - elapsed(), 1e-3);
+        ExactSearch search(reduced, params);
+        if(is_cycle) search.tighten(cost);
+        ExactSearchResult result = search.run(search.initialState());
+
+        if(!result.path.empty() && result.cost < cost){
+            path = result.path;
+            cost = result.cost;
+        }
+        std::cout << "Expanded Nodes: " << result.expanded_nodes << " ("
+                  << (result.complete ? "search complete" : result.gap_reached ? "stopped at gap threshold" : "stopped at time limit") << ")" << std::endl;
+        if(cost == std::numeric_limits<double>::infinity()){
+            std::cout << "No Hamiltonian cycle" << (result.complete ? "" : " found within the budget") << std::endl;
+            return;
+        }
+        stage("branch-and-bound", cost);
+        phase.end();
+
+        cost = evaluate(path);
+        std::cout << "Minimum Distance: " << cost << (result.complete ? " (optimal)" : "") << std::endl;
+        std::cout << "Execution Time: " << elapsed() << " seconds" << std::endl;
+        print_gap(cost);
+        return;
+    }
+
+    // construction plus local search on a distance matrix: travelCost, or the metric closure in incomplete graphs
+    // without coordinates
+    std::vector<double> dist;
+    std::unique_ptr<MetricClosure> closure;
+    if(closure_costs){
+        closure = std::make_unique<MetricClosure>(*delivery_graph, METRIC_CLOSURE_MEMORY);
+        if(!closure_tour(*closure, num_threads, path, dist)) return;
+        cost = delivery_graph->closureTourCost(path, *closure);
+        stage("closure-nn", cost);
+    }
+    else{
+        path = delivery_graph->greedyEdgeTour(GREEDY_EDGE_NEIGHBOURS, num_threads);
+        dist = delivery_graph->buildDistanceMatrix();
+        cost = delivery_graph->calculateTotalDistance(path);
+        stage("greedy-edge", cost);
+    }
+
+    double target = gap_threshold > 0.0 ? get_lower_bound() * (1.0 + gap_threshold) : 0.0;
+    cost = Graph::twoOptOnMatrix(path, dist, TWO_OPT_NEIGHBOURS, target);
+    stage("2-opt", cost);
+
+    if(budget >= AUTO_REFINE_SECONDS){
+        double remaining = budget - elapsed();
+        if(gap_reached(cost)){
+            std::cout << "Stage [ant-colony-2opt]: skipped, gap threshold reached" << std::endl;
+        }
+        else if(remaining < AUTO_REFINE_SECONDS){
+            std::cout << "Stage [ant-colony-2opt]: skipped, only " << remaining << " seconds left" << std::endl;
+        }
+        else{
+            AntColonyParams params;
+            params.ants = ANT_COLONY_ANTS;
+            params.max_iterations = ANT_COLONY_ITERATIONS;
+            params.max_seconds = remaining;
+            params.local_search = true;
+            params.threads = num_threads;
+            AntColony colony(dist, n, params);
+            AntColonyResult result = colony.run(path);
+            if(result.cost < cost){
+                path = result.path;
+                cost = result.cost;
+            }
+            stage("ant-colony-2opt", cost);
+        }
+    }
+    phase.end();
+
+    if(closure){
+        cost = delivery_graph->closureTourCost(path, *closure);
+        std::vector<int> route = delivery_graph->expandTour(path, *closure);
+        std::cout << "Minimum Distance: " << cost << std::endl;
+        std::cout << "Execution Time: " << elapsed() << " seconds" << std::endl;
+        print_route(route);
+        return;
+    }
+    cost = evaluate(path);
+    std::cout << "Minimum Distance: " << cost << std::endl;
+    std::cout << "Execution Time: " << elapsed() << " seconds" << std::endl;
+    print_gap(cost);
 }
 
+/// @brief Coordenador da resolução repartida por vários processos (ShardSpool).
+/// O espaço de procura é partido em shards: intervalos de vértices iniciais do vizinho mais próximo, sementes do
+/// MAX-MIN Ant System ou grupos de prefixos da pesquisa exata. Os shards são escritos na pasta partilhada e resolvidos
+/// por workers (projeto2DA --worker <pasta>), lançados aqui ou noutras máquinas que montem a mesma pasta. O
+/// coordenador junta os resultados, publica o melhor custo (que a pesquisa exata usa para cortar), devolve à fila os
+/// shards de workers sem sinais de vida e volta a lançar os workers locais que morram, no máximo SHARD_MAX_RESTARTS
+/// vezes cada; se todos os workers locais forem abandonados, a resolução termina.
+/// Um shard que um worker não consiga explorar (checkpoint ilegível ou de outro grafo) interrompe a resolução.
+/// Imprime o melhor ciclo, o número de shards e de shards devolvidos à fila, os shards resolvidos por cada worker e os
+/// shards que ficaram por resolver.
+/// @param job Problema e ficheiros do grafo (caminhos que os workers consigam abrir).
+/// @param spool_dir Pasta partilhada.
+/// @param local_workers Número de workers lançados nesta máquina (0 se só houver workers remotos).
+void Manager::sharded_solve(ShardJob job, const std::string& spool_dir, int local_workers){
+    int n = delivery_graph->getNumVertices();
+    if(n == 0){
+        std::cout << "The graph is empty" << std::endl;
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    job.time_limit = time_limit;
+    job.gap_threshold = gap_threshold;
+    job.lower_bound = job.kind == "backtracking" && gap_threshold > 0 ? get_lower_bound() : lower_bound;
+    ShardSpool spool(spool_dir);
+    if(!spool.create(job)){
+        std::cout << "Cannot create the spool directory " << spool_dir << std::endl;
+        return;
+    }
+
+    // shards are sized for the local workers; remote workers just share them
+    int workers = std::max(1, local_workers);
+    std::vector<std::string> payloads; // text shards (the exact search writes SearchCheckpoint files instead)
+    int shards = 0;
+    bool exact = job.kind == "backtracking";
+    if(job.kind == "nearest-neighbor"){
+        int count = std::min(n, workers * SHARD_STARTS_PER_WORKER);
+        for(int c = 0; c < count; c++){
+            payloads.push_back(std::to_string((long long)c * n / count) + " " + std::to_string((long long)(c + 1) * n / count));
+        }
+    }
+    else if(job.kind == "ant-colony"){
+        if(n < 3 || n > DENSE_MATRIX_VERTICES){
+            std::cout << "The ant colony needs between 3 and " << DENSE_MATRIX_VERTICES << " vertices" << std::endl;
+            return;
+        }
+        GraphProfile profile = delivery_graph->profile(0, 1);
+        if(!profile.complete && !profile.coordinates){
+            std::cout << "Graph is incomplete and has no coordinates; the sharded ant colony needs real distances "
+                      << "(use the ant colony, which runs on the metric closure)" << std::endl;
+            return;
+        }
+        for(int c = 0; c < workers * SHARD_SEEDS_PER_WORKER; c++) payloads.push_back(std::to_string(c + 1));
+    }
+    else if(exact){
+        // workers load the files in their original numbering, so the prefixes are built on it too
+        Graph reduced = *delivery_graph;
+        if(!original_id.empty()){
+            std::vector<int> current(n);
+            for(int v = 0; v < n; v++) current[original_id[v]] = v;
+            reduced.renumber(current);
+        }
+        PreprocessReport report = reduced.preprocess();
+        print_preprocess_report(report);
+        if(!report.feasible){
+            std::cout << "No Hamiltonian cycle: " << report.reason << std::endl;
+            return;
+        }
+        uint64_t fingerprint = ExactSearch::fingerprint(reduced);
+        std::vector<std::vector<int>> prefixes = ExactSearch::split(reduced, {{0}}, (size_t)workers * SHARD_PREFIXES_PER_WORKER);
+        int count = std::min((int)prefixes.size(), workers * SHARD_PREFIXES_PER_WORKER);
+        for(int c = 0; c < count; c++){
+            SearchCheckpoint shard;
+            shard.fingerprint = fingerprint;
+            shard.frontier.assign(prefixes.begin() + (size_t)c * prefixes.size() / count,
+                                  prefixes.begin() + (size_t)(c + 1) * prefixes.size() / count);
+            shards++;
+            if(!shard.save(spool.pendingPath(shard_id(c)))){
+                std::cout << "Cannot write shard " << shard_id(c) << std::endl;
+                return;
+            }
+        }
+    }
+    else{
+        std::cout << "Unknown shard kind: " << job.kind << std::endl;
+        return;
+    }
+    for(size_t c = 0; c < payloads.size(); c++){
+        if(!spool.addShard(shard_id(c), payloads[c])){
+            std::cout << "Cannot write shard " << shard_id(c) << std::endl;
+            return;
+        }
+        shards++;
+    }
+    std::cout << "Shards: " << shards << " (" << job.kind << ") in " << spool_dir << std::endl;
+
+    // local workers are this same executable in worker mode, logging to <spool>/logs
+    std::vector<pid_t> children(local_workers, -1);
+    std::vector<int> restarts(local_workers, 0);
+    auto spawn = [&](int i){
+        pid_t pid = fork();
+        if(pid == 0){
+            std::string log = spool_dir + "/logs/worker-" + std::to_string(i) + ".log";
+            int fd = open(log.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+            if(fd >= 0){
+                dup2(fd, STDOUT_FILENO);
+                dup2(fd, STDERR_FILENO);
+                close(fd);
+            }
+            execl("/proc/self/exe", "projeto2DA", "--worker", spool_dir.c_str(), (char*)nullptr);
+            _exit(127);
+        }
+        children[i] = pid;
+    };
+    for(int i = 0; i < local_workers; i++) spawn(i);
+
+    double best = std::numeric_limits<double>::infinity();
+    std::vector<int> best_path;
+    std::map<std::string, int> per_worker;
+    std::set<std::string> explored;
+    int finished = 0, requeued = 0, restarted = 0;
+    long long nodes = 0;
+    bool stopped_at_gap = false, failed = false;
+    while(true){
+        for(const ShardResult& result : spool.collectResults()){
+            if(!result.error.empty()){
+                // a shard that could not be explored is never counted, and retrying it would fail the same way
+                std::cout << "Shard " << result.id << " failed on worker " << result.worker << ": " << result.error << std::endl;
+                failed = true;
+                continue;
+            }
+            finished++;
+            explored.insert(result.id);
+            nodes += result.nodes;
+            per_worker[result.worker]++;
+            stopped_at_gap |= result.gap_reached;
+            if(result.cost < best && !result.path.empty()){
+                best = result.cost;
+                best_path = result.path;
+                spool.publishIncumbent(best);
+            }
+        }
+        if(gap_reached(best)) stopped_at_gap = true;
+        if(finished >= shards || stopped_at_gap || failed) break;
+
+        requeued += spool.requeueStale(SHARD_STALE_SECONDS);
+        int alive = 0;
+        for(int i = 0; i < local_workers; i++){
+            int status;
+            if(children[i] > 0 && waitpid(children[i], &status, WNOHANG) == children[i]){
+                children[i] = -1;
+                if(restarts[i] < SHARD_MAX_RESTARTS){
+                    std::cout << "Worker " << i << " exited, starting a new one" << std::endl;
+                    restarts[i]++;
+                    restarted++;
+                    spawn(i);
+                }
+                else{
+                    std::cout << "Worker " << i << " exited " << restarts[i] + 1 << " times, giving up on it (see "
+                              << spool_dir << "/logs/worker-" << i << ".log)" << std::endl;
+                }
+            }
+            if(children[i] > 0) alive++;
+        }
+        // without local workers left nothing guarantees progress, so the remaining shards are reported unfinished
+        if(local_workers > 0 && alive == 0) break;
+        std::this_thread::sleep_for(std::chrono::duration<double>(SHARD_POLL_SECONDS));
+    }
+    spool.requestStop();
+    for(pid_t pid : children){
+        int status;
+        if(pid > 0) waitpid(pid, &status, 0);
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    for(auto& worker : per_worker){
+        std::cout << "Worker [" << worker.first << "]: " << worker.second << " shard(s)" << std::endl;
+    }
+    std::cout << "Shards: " << finished << "/" << shards << " finished, " << requeued << " requeued, "
+              << restarted << " local worker(s) restarted" << std::endl;
+    if(finished < shards && !stopped_at_gap){
+        std::cout << "Unfinished Shards:";
+        for(int c = 0; c < shards; c++){
+            if(!explored.count(shard_id(c))) std::cout << " " << shard_id(c);
+        }
+        std::cout << std::endl;
+    }
+    if(best_path.empty()){
+        std::cout << "No tour found" << std::endl;
+        return;
+    }
+    std::cout << "Minimum Distance: " << best;
+    if(exact && finished >= shards && !stopped_at_gap) std::cout << " (optimal)";
+    std::cout << std::endl;
+    std::cout << "Execution Time: " << std::chrono::duration<double>(end - start).count() << " seconds" << std::endl;
+    if(exact) std::cout << "Expanded Nodes: " << nodes << (stopped_at_gap ? " (stopped at gap threshold)" : "") << std::endl;
+    print_gap(best);
+}
+
+/// @brief Worker da resolução repartida: reserva shards da pasta partilhada, resolve-os sobre o grafo deste Manager e
+/// publica os resultados, até o coordenador pedir para parar.
+/// Enquanto um shard corre, uma thread atualiza o seu sinal de vida e, na pesquisa exata, corta com o melhor custo
+/// publicado pelo coordenador; a pesquisa exata também guarda checkpoints no ficheiro do shard, para que outro worker
+/// a continue se este morrer.
+/// @param spool_dir Pasta partilhada.
+void Manager::shard_worker(const std::string& spool_dir){
+    ShardSpool spool(spool_dir);
+    ShardJob job;
+    if(!spool.readJob(job)){
+        std::cout << "No job in " << spool_dir << std::endl;
+        return;
+    }
+    std::string name = ShardSpool::workerName();
+    std::cout << "Worker " << name << ": " << job.kind << " shards from " << spool_dir << std::endl;
+
+    int n = delivery_graph->getNumVertices();
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    Graph reduced = *delivery_graph;
+    if(job.kind == "backtracking") reduced.preprocess();
+    std::vector<double> dist;
+
+    while(!spool.stopRequested()){
+        Shard shard;
+        if(!spool.claim(name, shard)){
+            std::this_thread::sleep_for(std::chrono::duration<double>(SHARD_POLL_SECONDS));
+            continue;
+        }
+        auto start = std::chrono::steady_clock::now();
+        ShardResult result;
+        result.id = shard.id;
+        result.worker = name;
+
+        std::mutex live_mutex;
+        ExactSearch* live = nullptr;
+        std::atomic<bool> running(true);
+        bool aborted = false;
+        std::thread heartbeat([&](){
+            auto next = std::chrono::steady_clock::now();
+            while(running.load()){
+                if(std::chrono::steady_clock::now() >= next){
+                    spool.heartbeat(shard);
+                    std::lock_guard<std::mutex> lock(live_mutex);
+                    if(live != nullptr){
+                        live->tighten(spool.readIncumbent());
+                        if(spool.stopRequested()) live->abort();
+                    }
+                    next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(SHARD_HEARTBEAT_SECONDS));
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+        });
+
+        if(job.kind == "nearest-neighbor"){
+            std::istringstream in(shard.payload);
+            int first = 0, last = 0;
+            in >> first >> last;
+            withStaticGraph(get_static_graph(), [&](const auto& g){
+                for(int s = std::max(0, first); s < std::min(n, last); s++){
+                    std::vector<int> path = nearestNeighbourT(g, s);
+                    if((int)path.size() < n) continue;
+                    double cost = tourCostT(g, path);
+                    if(cost < result.cost){
+                        result.cost = cost;
+                        result.path = path;
+                    }
+                }
+            });
+            if(!result.path.empty()) result.cost = evaluate(result.path);
+        }
+        else if(job.kind == "ant-colony"){
+            if(dist.empty()) dist = delivery_graph->buildDistanceMatrix();
+            AntColonyParams params;
+            params.ants = ANT_COLONY_ANTS;
+            params.max_iterations = ANT_COLONY_ITERATIONS;
+            params.max_seconds = job.time_limit;
+            params.local_search = true;
+            params.threads = num_threads;
+            params.seed = (unsigned)std::stoul(shard.payload);
+            std::vector<int> initial = delivery_graph->nearestNeighbour(0);
+            std::vector<bool> in_path(n, false);
+            for(int v : initial) in_path[v] = true;
+            for(int v = 0; v < n; v++){
+                if(!in_path[v]) initial.push_back(v);
+            }
+            AntColony colony(dist, n, params);
+            AntColonyResult colony_result = colony.run(initial);
+            result.path = colony_result.path;
+            result.cost = evaluate(result.path);
+        }
+        else if(job.kind == "backtracking"){
+            ExactSearchParams params;
+            params.threads = num_threads;
+            params.lower_bound = job.lower_bound;
+            params.gap_threshold = job.gap_threshold;
+            params.checkpoint_file = shard.path;
+            params.checkpoint_interval = SHARD_CHECKPOINT_SECONDS;
+            ExactSearch search(reduced, params);
+
+            SearchCheckpoint state;
+            if(!state.load(shard.path)) result.error = "unreadable checkpoint";
+            else if(state.fingerprint != ExactSearch::fingerprint(reduced)) result.error = "checkpoint built for another graph";
+            else{
+                search.tighten(spool.readIncumbent());
+                {
+                    std::lock_guard<std::mutex> lock(live_mutex);
+                    live = &search;
+                }
+                ExactSearchResult exact_result = search.run(std::move(state));
+                {
+                    std::lock_guard<std::mutex> lock(live_mutex);
+                    live = nullptr;
+                }
+                aborted = exact_result.aborted;
+                result.cost = exact_result.cost;
+                result.path = exact_result.path;
+                result.nodes = exact_result.expanded_nodes;
+                result.gap_reached = exact_result.gap_reached;
+            }
+        }
+
+        running.store(false);
+        heartbeat.join();
+        if(aborted) break;
+
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        spool.complete(shard, result);
+        std::cout << "Shard " << shard.id << ": " << (!result.error.empty() ? result.error : result.path.empty() ? "no better tour" : "cost " + std::to_string(result.cost))
+                  << " in " << result.seconds << " seconds" << std::endl;
+    }
+}
+
+/// @brief Nome do shard c, com zeros à esquerda para que a ordem alfabética seja a ordem dos shards.
+std::string Manager::shard_id(int c){
+    std::string id = std::to_string(c);
+    return std::string(id.size() < 6 ? 6 - id.size() : 0, '0') + id;
+}
+
+/// @brief Define o prazo dos solvers que correm contra o relógio (portefólio).
+/// @param seconds Prazo em segundos.
+void Manager::set_time_limit(double seconds){
+    time_limit = std::max(seconds, 0.0);
+}
+
+/// @brief Define o ficheiro onde o backtracking guarda periodicamente o seu estado e de onde o retoma.
+/// @param file Caminho do ficheiro; vazio desativa os checkpoints.
+/// @param interval_seconds Intervalo mínimo entre checkpoints (segundos).
+void Manager::set_checkpoint(const std::string& file, double interval_seconds){
+    checkpoint_file = file;
+    checkpoint_interval = std::max(interval_seconds, 0.1);
+}
+
+/// @brief Define o gap de otimalidade a partir do qual os algoritmos podem parar.
+/// @param threshold Gap relativo (por exemplo 0.05 para 5%); 0 desativa a paragem antecipada.
+void Manager::set_gap_threshold(double threshold){
+    gap_threshold = std::max(threshold, 0.0);
+}
+
+/// @brief Devolve o limite inferior de Held-Karp, calculando-o apenas na primeira chamada.
+/// O passo do método subgradiente usa um ciclo de referência próprio, pelo que o valor guardado não depende de quem o
+/// pediu primeiro.
+/// @return Limite inferior do custo de qualquer ciclo no grafo.
+double Manager::get_lower_bound(){
+    if(lower_bound <= 0.0){
+        lower_bound = delivery_graph->heldKarpBound(HELD_KARP_ITERATIONS, 0.0, &lower_bound_converged);
+    }
+    return lower_bound;
+}
+
+/// @brief Verifica se um custo já está dentro do gap de otimalidade pedido.
+/// @param cost Custo de um ciclo.
+/// @return True se estiver definido um limiar e o custo estiver a essa distância do limite inferior.
+bool Manager::gap_reached(double cost){
+    if(gap_threshold <= 0.0) return false;
+    double bound = get_lower_bound();
+    return bound > 0.0 && cost - bound <= gap_threshold * bound;
+}
+
+/// @brief Imprime o limite inferior e o gap de otimalidade de um ciclo.
+/// Em grafos grandes o limite só é calculado se já tiver sido pedido antes.
+/// @param cost Custo do ciclo.
+void Manager::print_gap(double cost){
+    if(lower_bound <= 0.0 && delivery_graph->getNumVertices() > HELD_KARP_AUTO_VERTICES){
+        std::cout << "Lower Bound: not computed for " << delivery_graph->getNumVertices() << " vertices (use the lower bound option)" << std::endl;
+        return;
+    }
+    double bound = get_lower_bound();
+    std::cout << "Lower Bound: " << bound << std::endl;
+    if(bound > 0.0){
+        std::cout << "Optimality Gap: " << (cost - bound) / bound * 100.0 << "%" << std::endl;
+    }
+}
+
+
+
+/// @brief Vizinho mais próximo sobre a closure métrica, a partir do vértice 0, e a matriz n*n da closure para a pesquisa
+/// local que se segue. Todas as linhas são pré-calculadas em paralelo, porque a matriz precisa de todas.
+/// @param closure Closure métrica do grafo.
+/// @param num_threads Número de threads usadas no pré-cálculo das linhas.
+/// @param path Ciclo encontrado, preenchido pela função.
+/// @param dist Matriz de distâncias da closure (row-major), preenchida pela função.
+/// @return False se o grafo for desconexo (e nesse caso já foi reportado).
+bool Manager::closure_tour(MetricClosure& closure, int num_threads, std::vector<int>& path, std::vector<double>& dist){
+    int n = delivery_graph->getNumVertices();
+    std::vector<int> sources(n);
+    for(int v = 0; v < n; v++) sources[v] = v;
+    closure.prefetch(sources, num_threads);
+
+    path = delivery_graph->nearestNeighbourClosure(0, closure);
+    if((int)path.size() < n){
+        std::cout << "Graph is disconnected: only " << path.size() << " of " << n << " vertices were reached" << std::endl;
+        return false;
+    }
+    dist.resize((size_t)n * n);
+    for(int u = 0; u < n; u++){
+        std::shared_ptr<const ClosureRow> row = closure.row(u);
+        std::copy(row->distance.begin(), row->distance.end(), dist.begin() + (size_t)u * n);
+    }
+    return true;
+}
+
+/// @brief Imprime o percurso real de um ciclo sobre a closure, com os vértices intermédios, pelos números originais.
+/// @param route Percurso devolvido por Graph::expandTour.
+void Manager::print_route(const std::vector<int>& route){
+    std::cout << "Route: ";
+    for(int i = 0; i < (int)route.size(); i++){
+        std::cout << original_vertex(route[i]) << (i + 1 < (int)route.size() ? " -> " : "");
+    }
+    std::cout << std::endl;
+}
+
+/// @brief Renumera os vértices para melhorar a localidade dos acessos à memória.
+/// Com coordenadas os vértices passam a estar pela ordem da curva de Hilbert, sem coordenadas pela ordem reverse
+/// Cuthill-McKee (Graph::localityOrder). A instanciação especializada é reconstruída e os vértices impressos nos
+/// resultados continuam a usar a numeração original.
+/// Imprime também o tempo gasto.
+void Manager::reorder_vertices(){
+    auto start = std::chrono::steady_clock::now();
+    MemPhase phase("reorder");
+
+    // the graph may be shared with the registry and other managers, so it is copied before being renumbered
+    int n = delivery_graph->getNumVertices();
+    std::shared_ptr<Graph> renumbered = std::make_shared<Graph>(*delivery_graph);
+    std::vector<int> order = renumbered->localityOrder();
+    renumbered->renumber(order);
+    delivery_graph = renumbered;
+
+    std::vector<int> previous = original_id;
+    original_id.resize(n);
+    for(int v = 0; v < n; v++){
+        original_id[v] = previous.empty() ? order[v] : previous[order[v]];
+    }
+    phase.end();
+    static_graph = AnyStaticGraph();
+    get_static_graph();
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "Vertex Order: " << (delivery_graph->hasCoordinates() ? "Hilbert curve" : "reverse Cuthill-McKee") << std::endl;
+    std::cout << "Execution Time: " << std::chrono::duration<double>(end - start).count() << " seconds" << std::endl;
+}
+
+/// @brief Devolve o número original de um vértice, antes de qualquer renumeração.
+/// @param vertex Número atual do vértice.
+/// @return Número do vértice nos ficheiros lidos.
+int Manager::original_vertex(int vertex){
+    return original_id.empty() ? vertex : original_id[vertex];
+}
+
+/// @brief Mede o efeito da renumeração dos vértices na pesquisa local.
+/// Corre o mesmo 2-opt (mesmo ciclo inicial, com os vértices renumerados) sobre o grafo atual e sobre uma cópia
+/// renumerada por Graph::localityOrder. O 2-opt lê sempre as distâncias do grafo, sem matriz, para que a ordem dos
+/// vértices em memória conte em qualquer tamanho. Cada ordem corre LOCALITY_BENCHMARK_RUNS vezes, alternando qual das
+/// duas corre primeiro em cada ronda, para que nenhuma beneficie sempre da cache já aquecida pela outra; são impressos
+/// o menor tempo, a mediana e a mediana dos cache misses. Os cache misses são lidos com perf_event_open e aparecem
+/// como n/a quando o kernel não os disponibiliza.
+void Manager::locality_benchmark(){
+    int n = delivery_graph->getNumVertices();
+    if(n == 0){
+        std::cout << "The graph is empty" << std::endl;
+        return;
+    }
+    MemPhase phase("solve");
+
+    std::vector<int> initial = delivery_graph->nearestNeighbour(0);
+    std::vector<bool> in_path(n, false);
+    for(int v : initial) in_path[v] = true;
+    for(int v = 0; v < n; v++){
+        if(!in_path[v]) initial.push_back(v);
+    }
+
+    Graph reordered = *delivery_graph;
+    std::vector<int> order = reordered.localityOrder();
+    reordered.renumber(order);
+    std::vector<int> new_id(n);
+    for(int v = 0; v < n; v++) new_id[order[v]] = v;
+    std::vector<int> relabelled(n);
+    for(int i = 0; i < n; i++) relabelled[i] = new_id[initial[i]];
+
+    struct Runs{
+        double cost = 0.0;
+        std::vector<double> seconds;
+        std::vector<long long> misses;
+    };
+    Runs current_runs, reordered_runs;
+
+    PerfCounter counter;
+    auto run = [&](const Graph& graph, std::vector<int> path, Runs& runs){
+        auto start = std::chrono::steady_clock::now();
+        counter.start();
+        graph.twoOpt(path, TWO_OPT_NEIGHBOURS, 0.0, false);
+        runs.cost = graph.calculateTotalDistance(path);
+        long long misses = counter.stop();
+        auto end = std::chrono::steady_clock::now();
+        runs.seconds.push_back(std::chrono::duration<double>(end - start).count());
+        runs.misses.push_back(misses);
+    };
+    for(int round = 0; round < LOCALITY_BENCHMARK_RUNS; round++){
+        if(round % 2 == 0){
+            run(*delivery_graph, initial, current_runs);
+            run(reordered, relabelled, reordered_runs);
+        }
+        else{
+            run(reordered, relabelled, reordered_runs);
+            run(*delivery_graph, initial, current_runs);
+        }
+    }
+
+    auto report = [](const std::string& name, Runs& runs){
+        std::sort(runs.seconds.begin(), runs.seconds.end());
+        std::sort(runs.misses.begin(), runs.misses.end());
+        long long misses = runs.misses[runs.misses.size() / 2];
+        std::cout << name << ": Distance " << runs.cost
+                  << ", Time " << runs.seconds.front() << " seconds (median " << runs.seconds[runs.seconds.size() / 2] << ")"
+                  << ", Cache Misses " << (misses < 0 ? std::string("n/a") : std::to_string(misses)) << std::endl;
+    };
+
+    std::cout << "Vertex Order: " << (delivery_graph->hasCoordinates() ? "Hilbert curve" : "reverse Cuthill-McKee") << std::endl;
+    std::cout << "Runs: " << LOCALITY_BENCHMARK_RUNS << " per order, alternating which order runs first" << std::endl;
+    report("Current order", current_runs);
+    report("Reordered", reordered_runs);
+}
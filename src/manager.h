@@ -7,9 +7,62 @@
 #include <algorithm>
 #include <limits>
 #include <iostream>
+#include <thread>
+#include <chrono>
+#include <map>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
 
 #include "utils/csv_reader.h"
 #include "utils/graph.h"
+#include "utils/graph_registry.h"
+#include "utils/metric_closure.h"
+#include "utils/static_graph.h"
+#include "utils/mem_stats.h"
+#include "utils/portfolio.h"
+#include "utils/ant_colony.h"
+#include "utils/perf_counter.h"
+#include "utils/exact_search.h"
+#include "utils/shard_spool.h"
+
+// acima deste número de vértices o vizinho mais próximo só testa NEAREST_NEIGHBOR_LARGE_STARTS vértices iniciais
+#define NEAREST_NEIGHBOR_ALL_STARTS 1000
+#define NEAREST_NEIGHBOR_LARGE_STARTS 4
+// iterações do método subgradiente usado no limite de Held-Karp
+#define HELD_KARP_ITERATIONS 3000
+// acima deste número de vértices o limite inferior só é calculado quando pedido explicitamente
+#define HELD_KARP_AUTO_VERTICES 1000
+// número de vértices pretendido em cada cluster do solver de divisão e conquista
+#define CLUSTER_SIZE 200
+// candidatos por vértice na pesquisa local 2-opt
+#define TWO_OPT_NEIGHBOURS 10
+// candidatos por vértice na heurística greedy edge
+#define GREEDY_EDGE_NEIGHBOURS 10
+// prazo por omissão do portefólio de solvers (segundos)
+#define PORTFOLIO_SECONDS 10.0
+// formigas e limite de iterações do MAX-MIN Ant System (o tempo é limitado por set_time_limit)
+#define ANT_COLONY_ANTS 25
+#define ANT_COLONY_ITERATIONS 2000
+// shards criados por worker local na resolução repartida: intervalos de vértices iniciais, sementes e grupos de prefixos
+#define SHARD_STARTS_PER_WORKER 8
+#define SHARD_SEEDS_PER_WORKER 2
+#define SHARD_PREFIXES_PER_WORKER 8
+// modo automático: até este número de vértices (com arestas) é usada a pesquisa exata
+#define AUTO_EXACT_VERTICES 15
+// modo automático: triplos amostrados no perfil do grafo
+#define AUTO_PROFILE_SAMPLES 20000
+// modo automático: acima desta fração de triplos que violam a desigualdade triangular o grafo não é tratado como métrico
+#define AUTO_METRIC_VIOLATION_RATE 0.01
+// modo automático: tempo estimado por vértice do solver por clusters (segundos), comparado com o prazo
+#define AUTO_CLUSTER_SECONDS_PER_VERTEX 5e-5
+// modo automático: tempo mínimo que tem de sobrar para refinar o ciclo com a colónia de formigas (segundos)
+#define AUTO_REFINE_SECONDS 1.0
+// repetições de cada ordem no benchmark de localidade (as duas ordens alternam qual corre primeiro)
+#define LOCALITY_BENCHMARK_RUNS 5
+// memória máxima ocupada pelas linhas em cache da closure métrica (bytes)
+#define METRIC_CLOSURE_MEMORY ((size_t)256 * 1024 * 1024)
 
 class Manager {
 public:
@@ -17,6 +70,7 @@ public:
     Manager();
     Manager (const char *nodes_file, const char *edges_file);
     Manager (const char *f_name);
+    Manager (std::shared_ptr<const Graph> graph);
 
     void initialize_graphs_with_2_files();
 
@@ -30,19 +84,95 @@ public:
 
     void nearest_neighbor();
 
+    void space_filling_curve();
+
+    void held_karp_bound();
+
+    void clustered_tour();
+
+    void two_opt();
+
+    void nearest_neighbor_closure();
+
+    void greedy_edge(bool all_edges);
+
+    void portfolio();
+
+    void ant_colony(bool local_search);
+
+    void auto_solve();
+
+    void sharded_solve(ShardJob job, const std::string& spool_dir, int local_workers);
+
+    void shard_worker(const std::string& spool_dir);
+
+    void set_gap_threshold(double threshold);
+
+    void set_time_limit(double seconds);
+
+    void set_checkpoint(const std::string& file, double interval_seconds);
+
+    void set_memory_tracking(bool enabled);
+
+    void print_memory_report();
+
+    void reorder_vertices();
+
+    void locality_benchmark();
+
 
 private:
+    const AnyStaticGraph& get_static_graph();
+
+    double evaluate(const std::vector<int>& path);
+
+    std::vector<int> mst_parent() const;
+
+    double get_lower_bound();
+
+    bool gap_reached(double cost);
+
+    void print_gap(double cost);
+
+    bool closure_tour(MetricClosure& closure, int num_threads, std::vector<int>& path, std::vector<double>& dist);
+
+    void print_route(const std::vector<int>& route);
+
+    void print_preprocess_report(const PreprocessReport& report);
+
+    int original_vertex(int vertex);
+
+    static std::string shard_id(int c);
+
     CsvReader nodes_reader;
     CsvReader edges_reader;
 
-    // graph structure
-    Graph delivery_graph;
+    // graph structure; may be shared with the GraphRegistry, so it is only read (reorder_vertices replaces it with a copy)
+    std::shared_ptr<const Graph> delivery_graph;
     
     // subgraph structure for use without select segments
     // Graph sub_graph;
 
+    // instanciação especializada do grafo, construída por get_static_graph quando é precisa
+    AnyStaticGraph static_graph;
+
+    // número original de cada vértice depois de reorder_vertices (vazio enquanto não houver renumeração)
+    std::vector<int> original_id;
+
     // hash map of strings to vertex numbers
     std::unordered_map<std::string, int> vertex_map;
+
+    // limite inferior de Held-Karp (0 enquanto não for calculado)
+    double lower_bound = 0.0;
+    // se o método subgradiente convergiu antes do limite de iterações
+    bool lower_bound_converged = false;
+    // os solvers param quando (custo - limite) / limite <= gap_threshold
+    double gap_threshold = 0.0;
+    // prazo dos solvers que correm contra o relógio (segundos)
+    double time_limit = PORTFOLIO_SECONDS;
+    // ficheiro de checkpoint do backtracking (vazio se desativado) e intervalo entre checkpoints (segundos)
+    std::string checkpoint_file;
+    double checkpoint_interval = CHECKPOINT_INTERVAL;
 };
 
 #endif //PROJETODA2_MANAGER_H
\ No newline at end of file
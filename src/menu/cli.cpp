@@ -0,0 +1,137 @@
+#include "cli.h"
+
+/// @brief Lê as opções da linha de comandos.
+/// @param argc Número de argumentos.
+/// @param argv Argumentos.
+CommandLine::CommandLine(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "-g" && has_value) graph_file = argv[++i];
+        else if (arg == "-n" && has_value) nodes_file = argv[++i];
+        else if (arg == "-e" && has_value) edges_file = argv[++i];
+        else if (arg == "-a" && has_value) selected.push_back(argv[++i]);
+        else if (arg == "--gap" && has_value) gap_percent = std::stod(argv[++i]);
+        else if (arg == "--time-limit" && has_value) time_limit = std::stod(argv[++i]);
+        else if (arg == "--checkpoint" && has_value) checkpoint_file = argv[++i];
+        else if (arg == "--checkpoint-interval" && has_value) checkpoint_interval = std::stod(argv[++i]);
+        else if (arg == "--spool" && has_value) spool_dir = argv[++i];
+        else if (arg == "--workers" && has_value) local_workers = std::max(0, std::stoi(argv[++i]));
+        else if (arg == "--worker" && has_value) worker_spool = argv[++i];
+        else if (arg == "--mem-stats") memory_tracking = true;
+        else valid = false;
+    }
+
+    if (!worker_spool.empty()) return;
+    if (graph_file.empty() == (nodes_file.empty() || edges_file.empty())) valid = false;
+    if (selected.empty()) valid = false;
+}
+
+/// @brief Algoritmos disponíveis na linha de comandos, pelo nome.
+std::map<std::string, std::function<void(Manager&)>> CommandLine::algorithms() {
+    return {
+        {"backtracking", [](Manager& m) { m.backtrack_tsp(); }},
+        {"triangular", [](Manager& m) { m.triangularApproximation(); }},
+        {"nearest-neighbor", [](Manager& m) { m.nearest_neighbor(); }},
+        {"space-filling-curve", [](Manager& m) { m.space_filling_curve(); }},
+        {"held-karp", [](Manager& m) { m.held_karp_bound(); }},
+        {"clustering", [](Manager& m) { m.clustered_tour(); }},
+        {"two-opt", [](Manager& m) { m.two_opt(); }},
+        {"closure-nn", [](Manager& m) { m.nearest_neighbor_closure(); }},
+        {"greedy-edge", [](Manager& m) { m.greedy_edge(false); }},
+        {"greedy-edge-full", [](Manager& m) { m.greedy_edge(true); }},
+        {"portfolio", [](Manager& m) { m.portfolio(); }},
+        {"ant-colony", [](Manager& m) { m.ant_colony(false); }},
+        {"ant-colony-2opt", [](Manager& m) { m.ant_colony(true); }},
+        {"auto", [](Manager& m) { m.auto_solve(); }},
+        {"reorder", [](Manager& m) { m.reorder_vertices(); }},
+        {"locality-benchmark", [](Manager& m) { m.locality_benchmark(); }},
+        {"sharded-nearest-neighbor", [this](Manager& m) { m.sharded_solve(shardJob("nearest-neighbor"), spool_dir, local_workers); }},
+        {"sharded-ant-colony", [this](Manager& m) { m.sharded_solve(shardJob("ant-colony"), spool_dir, local_workers); }},
+        {"sharded-backtracking", [this](Manager& m) { m.sharded_solve(shardJob("backtracking"), spool_dir, local_workers); }},
+    };
+}
+
+/// @brief Trabalho da resolução repartida, com os caminhos absolutos dos ficheiros do grafo para que os workers os
+/// abram a partir de qualquer pasta (noutras máquinas, os ficheiros têm de estar no mesmo caminho).
+/// @param kind Problema a repartir.
+ShardJob CommandLine::shardJob(const std::string& kind) const {
+    ShardJob job;
+    job.kind = kind;
+    if (graph_file.empty()) {
+        job.nodes_file = std::filesystem::absolute(nodes_file).string();
+        job.edges_file = std::filesystem::absolute(edges_file).string();
+    } else {
+        job.edges_file = std::filesystem::absolute(graph_file).string();
+    }
+    return job;
+}
+
+/// @brief Modo worker: espera pelo trabalho na pasta partilhada, carrega o grafo indicado e resolve shards até o
+/// coordenador pedir para parar.
+/// @return Código de saída do programa (0 em caso de sucesso).
+int CommandLine::runWorker() {
+    ShardSpool spool(worker_spool);
+    ShardJob job;
+    if (!spool.readJob(job)) {
+        std::cout << "Waiting for a job in " << worker_spool << std::endl;
+        while (!spool.readJob(job)) std::this_thread::sleep_for(std::chrono::duration<double>(SHARD_POLL_SECONDS));
+    }
+
+    Manager m = job.nodes_file.empty() ? Manager(job.edges_file.c_str()) : Manager(job.nodes_file.c_str(), job.edges_file.c_str());
+    if (job.nodes_file.empty()) m.initialize_graphs_with_1_file();
+    else m.initialize_graphs_with_2_files();
+    m.set_gap_threshold(job.gap_threshold);
+    m.shard_worker(worker_spool);
+    return 0;
+}
+
+/// @brief Imprime a forma de uso e os algoritmos disponíveis.
+void CommandLine::printUsage() const {
+    std::cout << "Usage: projeto2DA -g <graph.csv> -a <algorithm> [-a <algorithm> ...] [--gap <percent>] [--time-limit <seconds>] [--mem-stats]" << std::endl;
+    std::cout << "                 [--checkpoint <file>] [--checkpoint-interval <seconds>] [--spool <dir>] [--workers <count>]" << std::endl;
+    std::cout << "       projeto2DA --worker <dir>" << std::endl;
+    std::cout << "       projeto2DA -n <nodes.csv> -e <edges.csv> -a <algorithm> ..." << std::endl;
+    std::cout << "Algorithms:";
+    for (auto &algorithm : const_cast<CommandLine*>(this)->algorithms()) {
+        std::cout << " " << algorithm.first;
+    }
+    std::cout << std::endl;
+}
+
+/// @brief Carrega o grafo e corre os algoritmos pedidos, pela ordem em que foram indicados.
+/// @return Código de saída do programa (0 em caso de sucesso).
+int CommandLine::run() {
+    if (!worker_spool.empty()) return runWorker();
+
+    std::map<std::string, std::function<void(Manager&)>> available = algorithms();
+    for (const std::string& name : selected) {
+        if (available.count(name) == 0) {
+            std::cout << "Unknown algorithm: " << name << std::endl;
+            valid = false;
+        }
+    }
+    if (!valid) {
+        printUsage();
+        return 1;
+    }
+
+    MemStats::enable(memory_tracking);
+    Manager m = graph_file.empty() ? Manager(nodes_file.c_str(), edges_file.c_str()) : Manager(graph_file.c_str());
+    if (graph_file.empty()) m.initialize_graphs_with_2_files();
+    else m.initialize_graphs_with_1_file();
+    m.set_gap_threshold(gap_percent / 100.0);
+    m.set_time_limit(time_limit);
+    m.set_checkpoint(checkpoint_file, checkpoint_interval);
+    m.print_memory_report();
+
+    for (const std::string& name : selected) {
+        std::cout << "##############################################" << std::endl;
+        std::cout << "Algorithm: " << name << std::endl;
+        available[name](m);
+        m.print_memory_report();
+    }
+    std::cout << "##############################################" << std::endl;
+    return 0;
+}
@@ -0,0 +1,46 @@
+#ifndef PROJETO2DA_CLI_H
+#define PROJETO2DA_CLI_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include "../manager.h"
+
+// modo não interativo: carrega um grafo e corre os algoritmos indicados na linha de comandos
+//   projeto2DA -g <graph.csv> -a <algorithm> [-a <algorithm> ...] [--gap <percent>] [--time-limit <seconds>] [--mem-stats]
+//              [--checkpoint <file>] [--checkpoint-interval <seconds>] [--spool <dir>] [--workers <count>]
+//   projeto2DA --worker <dir>      (worker da resolução repartida: resolve shards da pasta até o coordenador parar)
+//   projeto2DA -n <nodes.csv> -e <edges.csv> -a <algorithm> ...
+class CommandLine {
+public:
+    CommandLine(int argc, char **argv);
+
+    int run();
+
+private:
+    void printUsage() const;
+
+    std::map<std::string, std::function<void(Manager&)>> algorithms();
+
+    ShardJob shardJob(const std::string& kind) const;
+
+    int runWorker();
+
+    std::string graph_file;
+    std::string nodes_file;
+    std::string edges_file;
+    std::vector<std::string> selected;
+    double gap_percent = 0.0;
+    double time_limit = PORTFOLIO_SECONDS;
+    std::string checkpoint_file;
+    double checkpoint_interval = CHECKPOINT_INTERVAL;
+    std::string spool_dir = "spool";
+    int local_workers = std::max(1u, std::thread::hardware_concurrency());
+    std::string worker_spool;
+    bool memory_tracking = false;
+    bool valid = true;
+};
+
+#endif //PROJETO2DA_CLI_H
@@ -6,7 +6,18 @@
 #include "../manager.h"
 
 /// @brief Constrói um objeto Menu, responsável por gerenciar o menu do programa.
-Menu::Menu() : m("../dataset/Extra_Fully_Connected_Graphs/edges_900.csv") {}
+/// Regista no GraphRegistry os datasets que aparecem no menu; nenhum grafo é lido até ser pedido ou pré-carregado.
+Menu::Menu() : m(std::make_shared<const Graph>(true)) {
+    GraphRegistry& registry = GraphRegistry::instance();
+    registry.add("shipping", TOY_GRAPH_PATH "shipping.csv");
+    registry.add("stadiums", TOY_GRAPH_PATH "stadiums.csv");
+    registry.add("tourism", TOY_GRAPH_PATH "tourism.csv");
+    for (const char* name : {"graph1", "graph2", "graph3"}) {
+        std::string folder = std::string(REAL_WORLD_GRAPH_PATH) + name + "/";
+        registry.add(name, folder + "nodes.csv", folder + "edges.csv");
+    }
+}
+
 void Menu::menuLoop() {
     while(!exited) {
         switch (menuState) {
@@ -28,7 +39,13 @@ void Menu::menuLoop() {
 }
 
 /// @brief Imprime o menu que permite selecionar diferentes grafos.
+/// Os datasets listados começam a ser carregados em segundo plano assim que o menu é mostrado.
 void Menu::graphSelectionMenu() {
+    GraphRegistry& registry = GraphRegistry::instance();
+    for (const char* name : {"shipping", "stadiums", "tourism", "graph1", "graph2", "graph3"}) {
+        registry.preload(name);
+    }
+
     while((menuState == -1) && !exited) {
         std::cout << "Select a graph:" << std::endl;
         std::cout << "1 - shipping.csv (Toy-Graph)" << std::endl;
@@ -38,6 +55,9 @@ void Menu::graphSelectionMenu() {
         std::cout << "5 - graph2 (Real-World-Graph)" << std::endl;
         std::cout << "6 - graph3 (Real-World-Graph)" << std::endl;
         std::cout << "7 - select an extra graph from Extra_Fully_Connected_Graphs folder" << std::endl;
+        std::cout << "8 - preload an extra graph in the background" << std::endl;
+        std::cout << "9 - show the load status of each graph" << std::endl;
+        std::cout << "10 - set the memory cap of loaded graphs" << std::endl;
         std::cout << "0 - Exit" << std::endl;
         std::cout << "Option: ";
         int option = -1;
@@ -46,55 +66,46 @@ void Menu::graphSelectionMenu() {
             case 0:
                 exited = true;
                 break;
-            case 1: {
-                m = Manager("../dataset/Toy-Graphs/shipping.csv");
-                m.initialize_graphs_with_1_file();
-                menuState = 0;
+            case 1:
+                selectGraph("shipping");
                 break;
-            }
-            case 2: {
-                m = Manager("../dataset/Toy-Graphs/stadiums.csv");
-                m.initialize_graphs_with_1_file();
-                menuState = 0;
+            case 2:
+                selectGraph("stadiums");
                 break;
-            }
-            case 3: {
-                m = Manager("../dataset/Toy-Graphs/tourism.csv");
-                m.initialize_graphs_with_1_file();
-                menuState = 0;
+            case 3:
+                selectGraph("tourism");
                 break;
-            }
-            case 4: {
-                m = Manager("../dataset/Real-World-Graphs/graph1/nodes.csv",
-                            "../dataset/Real-World-Graphs/graph1/edges.csv");
-                m.initialize_graphs_with_2_files();
-                menuState = 0;
+            case 4:
+                selectGraph("graph1");
                 break;
-            }
-            case 5: {
-                m = Manager("../dataset/Real-World-Graphs/graph2/nodes.csv",
-                            "../dataset/Real-World-Graphs/graph2/edges.csv");
-                m.initialize_graphs_with_2_files();
-                menuState = 0;
+            case 5:
+                selectGraph("graph2");
                 break;
-            }
-            case 6: {
-                m = Manager("../dataset/Real-World-Graphs/graph3/nodes.csv",
-                            "../dataset/Real-World-Graphs/graph3/edges.csv");
-                m.initialize_graphs_with_2_files();
-                menuState = 0;
+            case 6:
+                selectGraph("graph3");
                 break;
-            }
             case 7: {
                 std::cout << "Enter the name of the file (without the .csv extension): ";
                 std::string filename;
                 std::cin >> filename;
-
-                std::string edge_path = EXTRA_FULLY_CONNECTED_GRAPHS_PATH + filename + ".csv";
-                std::cout << "nodes_path: " << edge_path << std::endl;
-                m = Manager(edge_path.c_str());
-                m.initialize_graphs_with_1_file();
-                menuState = 0;
+                selectGraph(registerExtraGraph(filename));
+                break;
+            }
+            case 8: {
+                std::cout << "Enter the name of the file (without the .csv extension): ";
+                std::string filename;
+                std::cin >> filename;
+                registry.preload(registerExtraGraph(filename));
+                break;
+            }
+            case 9:
+                registry.printStatus(std::cout);
+                break;
+            case 10: {
+                std::cout << "Memory cap (MB): ";
+                double megabytes = 0;
+                std::cin >> megabytes;
+                registry.setMemoryCap((size_t)(std::max(0.0, megabytes) * 1024 * 1024));
                 break;
             }
             default:
@@ -104,6 +115,30 @@ void Menu::graphSelectionMenu() {
     }
 }
 
+/// @brief Regista no GraphRegistry um grafo da pasta Extra_Fully_Connected_Graphs.
+/// @param filename Nome do ficheiro, sem a extensão .csv.
+/// @return Nome do dataset no registo.
+std::string Menu::registerExtraGraph(const std::string& filename) {
+    std::string edge_path = EXTRA_FULLY_CONNECTED_GRAPHS_PATH + filename + ".csv";
+    GraphRegistry::instance().add(filename, edge_path);
+    return filename;
+}
+
+/// @brief Seleciona um dataset do GraphRegistry, esperando pelo carregamento se ainda não tiver terminado.
+/// O grafo partilhado é reutilizado: mudar de dataset nunca volta a ler um ficheiro já carregado.
+/// Com a instrumentação de memória ativa, imprime as fases de carregamento terminadas desde o último relatório.
+/// @param name Nome do dataset.
+void Menu::selectGraph(const std::string& name) {
+    std::shared_ptr<const Graph> graph = GraphRegistry::instance().get(name);
+    if (graph == nullptr) {
+        std::cout << "Could not load " << name << std::endl;
+        return;
+    }
+    m = Manager(graph);
+    m.print_memory_report();
+    menuState = 0;
+}
+
 /// @brief Imprime o menu que permite aplicar um algoritmo a um grafo anteriormente selecionado.
 void Menu::algorithmSelectionMenu() {
     while((menuState == 0) && !exited) {
@@ -111,10 +146,29 @@ void Menu::algorithmSelectionMenu() {
         std::cout << "1 - Backtracking" << std::endl;
         std::cout << "2 - Triangular Approximation" << std::endl;
         std::cout << "3 - Nearest neighbor algorithm (adapted)" << std::endl;
+        std::cout << "4 - Held-Karp lower bound" << std::endl;
+        std::cout << "5 - Set optimality gap threshold" << std::endl;
+        std::cout << "6 - Divide-and-conquer clustering (large graphs)" << std::endl;
+        std::cout << "7 - Nearest neighbor + 2-opt local search" << std::endl;
+        std::cout << "8 - Nearest neighbor over shortest paths (sparse graphs)" << std::endl;
+        std::cout << "9 - " << (MemStats::isEnabled() ? "Disable" : "Enable") << " memory tracking" << std::endl;
+        std::cout << "10 - Reorder vertices for memory locality" << std::endl;
+        std::cout << "11 - Compare 2-opt before and after reordering" << std::endl;
+        std::cout << "12 - Greedy edge (nearest neighbour candidates)" << std::endl;
+        std::cout << "13 - Greedy edge (all edges)" << std::endl;
+        std::cout << "14 - Hilbert space-filling curve (graphs with coordinates)" << std::endl;
+        std::cout << "15 - Select another graph" << std::endl;
+        std::cout << "16 - Portfolio: race backtracking, triangular and nearest neighbor" << std::endl;
+        std::cout << "17 - Set time limit" << std::endl;
+        std::cout << "18 - Ant colony (MAX-MIN Ant System)" << std::endl;
+        std::cout << "19 - Ant colony + 2-opt on the best ant" << std::endl;
+        std::cout << "20 - Set checkpoint file for backtracking" << std::endl;
+        std::cout << "21 - Auto: profile the graph and pick a solver within the time limit" << std::endl;
         std::cout << "0 - Exit" << std::endl;
         std::cout << "Option: ";
         int option = -1;
         std::cin >> option;
+        MemStats::clearPhases();
         switch (option) {
             case 0:
                 exited = true;
@@ -122,6 +176,7 @@ void Menu::algorithmSelectionMenu() {
             case 1: {
                 std::cout << "##############################################" << std::endl;
                 m.backtrack_tsp();
+                m.print_memory_report();
                 std::cout << "##############################################" << std::endl;
                 menuState = 0;
                 break;
@@ -129,6 +184,7 @@ void Menu::algorithmSelectionMenu() {
             case 2: {
                 std::cout << "##############################################" << std::endl;
                 m.triangularApproximation();
+                m.print_memory_report();
                 std::cout << "##############################################" << std::endl;
                 menuState = 0;
                 break;
@@ -136,6 +192,149 @@ void Menu::algorithmSelectionMenu() {
             case 3: {
                 std::cout << "##############################################" << std::endl;
                 m.nearest_neighbor();
+                m.print_memory_report();
+                std::cout << "##############################################" << std::endl;
+                menuState = 0;
+                break;
+            }
+            case 4: {
+                std::cout << "##############################################" << std::endl;
+                m.held_karp_bound();
+                m.print_memory_report();
+                std::cout << "##############################################" << std::endl;
+                menuState = 0;
+                break;
+            }
+            case 5: {
+                std::cout << "Enter the gap threshold in percent (0 to disable): ";
+                double threshold = 0.0;
+                std::cin >> threshold;
+                m.set_gap_threshold(threshold / 100.0);
+                menuState = 0;
+                break;
+            }
+            case 6: {
+                std::cout << "##############################################" << std::endl;
+                m.clustered_tour();
+                m.print_memory_report();
+                std::cout << "##############################################" << std::endl;
+                menuState = 0;
+                break;
+            }
+            case 7: {
+                std::cout << "##############################################" << std::endl;
+                m.two_opt();
+                m.print_memory_report();
+                std::cout << "##############################################" << std::endl;
+                menuState = 0;
+                break;
+            }
+            case 8: {
+                std::cout << "##############################################" << std::endl;
+                m.nearest_neighbor_closure();
+                m.print_memory_report();
+                std::cout << "##############################################" << std::endl;
+                menuState = 0;
+                break;
+            }
+            case 9: {
+                m.set_memory_tracking(!MemStats::isEnabled());
+                menuState = 0;
+                break;
+            }
+            case 10: {
+                std::cout << "##############################################" << std::endl;
+                m.reorder_vertices();
+                m.print_memory_report();
+                std::cout << "##############################################" << std::endl;
+                menuState = 0;
+                break;
+            }
+            case 11: {
+                std::cout << "##############################################" << std::endl;
+                m.locality_benchmark();
+                m.print_memory_report();
+                std::cout << "##############################################" << std::endl;
+                menuState = 0;
+                break;
+            }
+            case 12: {
+                std::cout << "##############################################" << std::endl;
+                m.greedy_edge(false);
+                m.print_memory_report();
+                std::cout << "##############################################" << std::endl;
+                menuState = 0;
+                break;
+            }
+            case 13: {
+                std::cout << "##############################################" << std::endl;
+                m.greedy_edge(true);
+                m.print_memory_report();
+                std::cout << "##############################################" << std::endl;
+                menuState = 0;
+                break;
+            }
+            case 14: {
+                std::cout << "##############################################" << std::endl;
+                m.space_filling_curve();
+                m.print_memory_report();
+                std::cout << "##############################################" << std::endl;
+                menuState = 0;
+                break;
+            }
+            case 15: {
+                menuState = -1;
+                break;
+            }
+            case 16: {
+                std::cout << "##############################################" << std::endl;
+                m.portfolio();
+                m.print_memory_report();
+                std::cout << "##############################################" << std::endl;
+                menuState = 0;
+                break;
+            }
+            case 17: {
+                std::cout << "Time limit (seconds): ";
+                double seconds = 0;
+                std::cin >> seconds;
+                m.set_time_limit(seconds);
+                menuState = 0;
+                break;
+            }
+            case 18: {
+                std::cout << "##############################################" << std::endl;
+                m.ant_colony(false);
+                m.print_memory_report();
+                std::cout << "##############################################" << std::endl;
+                menuState = 0;
+                break;
+            }
+            case 19: {
+                std::cout << "##############################################" << std::endl;
+                m.ant_colony(true);
+                m.print_memory_report();
+                std::cout << "##############################################" << std::endl;
+                menuState = 0;
+                break;
+            }
+            case 20: {
+                std::cout << "Checkpoint file (- to disable): ";
+                std::string file;
+                std::cin >> file;
+                double seconds = CHECKPOINT_INTERVAL;
+                if (file != "-") {
+                    std::cout << "Checkpoint interval (seconds): ";
+                    std::cin >> seconds;
+                }
+                m.set_checkpoint(file == "-" ? "" : file, seconds);
+                menuState = 0;
+                break;
+            }
+            case 21: {
+                std::cout << "##############################################" << std::endl;
+                m.auto_solve();
+                m.print_memory_report();
                 std::cout << "##############################################" << std::endl;
                 menuState = 0;
                 break;
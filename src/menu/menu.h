@@ -24,6 +24,9 @@ private:
     void graphSelectionMenu(); // -1
     void algorithmSelectionMenu(); // 0
 
+    std::string registerExtraGraph(const std::string& filename);
+    void selectGraph(const std::string& name);
+
     Manager m;
     int menuState = -1; // -1 means a graph has not been selected yet
     bool exited = false;
@@ -0,0 +1,190 @@
+#include "utils/graph.h"
+#include "utils/union_find.h"
+
+#include <chrono>
+#include <set>
+
+/// @brief Remove a aresta entre dois vértices, nos dois sentidos.
+/// Esta função tem complexidade O(grau(v1) + grau(v2)).
+/// @param v1 Vértice 1.
+/// @param v2 Vértice 2.
+/// @return True se alguma aresta foi removida.
+bool Graph::removeEdge(int v1, int v2) {
+    bool removed = false;
+    for (int pass = 0; pass < 2; pass++) {
+        std::vector<edgeNode>& adj = vertices[pass == 0 ? v1 : v2].adj;
+        int target = pass == 0 ? v2 : v1;
+        for (auto it = adj.begin(); it != adj.end(); ++it) {
+            if (it->vertex == target) {
+                adj.erase(it);
+                num_edges--;
+                removed = true;
+                break;
+            }
+        }
+    }
+    return removed;
+}
+
+/// @brief Prepara o grafo para uma pesquisa exata de ciclos hamiltonianos.
+/// Deteta condições que tornam a instância impossível (componentes desligadas, pontos de articulação e vértices de
+/// grau inferior a 2), fixa as arestas forçadas pelos vértices de grau 2 e remove as arestas dominadas, isto é, as
+/// restantes arestas de vértices que já têm duas arestas forçadas e as que fechariam um subciclo com um caminho de
+/// arestas forçadas. A propagação é repetida até estabilizar.
+/// As arestas removidas são retiradas do próprio grafo, pelo que deve ser chamada sobre uma cópia.
+/// Esta função tem complexidade O(V + E) mais O(grau) por aresta removida.
+/// @return Relatório com o que foi detetado e removido, e o tempo gasto.
+PreprocessReport Graph::preprocess() {
+    auto start = std::chrono::steady_clock::now();
+    int n = vertices.size();
+
+    PreprocessReport report;
+    report.feasible = true;
+    report.components = n > 0 ? 1 : 0;
+    report.removed_edges = 0;
+
+    // undirected neighbour sets, without self loops
+    std::vector<std::set<int>> neighbours(n);
+    for (auto& vertex : vertices) {
+        for (const edgeNode& edge : vertex.second.adj) {
+            if (edge.vertex != vertex.first) {
+                neighbours[vertex.first].insert(edge.vertex);
+                neighbours[edge.vertex].insert(vertex.first);
+            }
+        }
+    }
+
+    auto finish = [&](const std::string& reason) {
+        if (!reason.empty()) {
+            report.feasible = false;
+            if (report.reason.empty()) report.reason = reason;
+        }
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return report;
+    };
+
+    if (n < 3) return finish(n == 0 ? "empty graph" : "");
+
+    for (int v = 0; v < n; v++) {
+        if (neighbours[v].size() < 2) report.low_degree_vertices.push_back(v);
+    }
+
+    // connected components and articulation points with an iterative Tarjan DFS
+    std::vector<int> discovery(n, -1), low(n, 0), parent(n, -1);
+    std::vector<bool> articulation(n, false);
+    int timer = 0;
+    report.components = 0;
+    for (int root = 0; root < n; root++) {
+        if (discovery[root] != -1) continue;
+        report.components++;
+
+        int root_children = 0;
+        std::stack<std::pair<int, std::set<int>::iterator>> stack;
+        discovery[root] = low[root] = timer++;
+        stack.push(std::make_pair(root, neighbours[root].begin()));
+
+        while (!stack.empty()) {
+            int v = stack.top().first;
+            std::set<int>::iterator& it = stack.top().second;
+
+            if (it != neighbours[v].end()) {
+                int w = *it;
+                ++it;
+                if (discovery[w] == -1) {
+                    parent[w] = v;
+                    if (v == root) root_children++;
+                    discovery[w] = low[w] = timer++;
+                    stack.push(std::make_pair(w, neighbours[w].begin()));
+                } else if (w != parent[v]) {
+                    low[v] = std::min(low[v], discovery[w]);
+                }
+            } else {
+                stack.pop();
+                int p = parent[v];
+                if (p != -1) {
+                    low[p] = std::min(low[p], low[v]);
+                    if (p != root && low[v] >= discovery[p]) articulation[p] = true;
+                }
+            }
+        }
+        if (root_children > 1) articulation[root] = true;
+    }
+    for (int v = 0; v < n; v++) {
+        if (articulation[v]) report.articulation_points.push_back(v);
+    }
+
+    if (report.components > 1) return finish("graph is disconnected");
+    if (!report.low_degree_vertices.empty()) return finish("vertex with degree below 2");
+    if (!report.articulation_points.empty()) return finish("graph has articulation points");
+
+    // forced edges: both edges of a degree-2 vertex belong to every Hamiltonian cycle
+    std::vector<std::set<int>> forced(n);
+    UnionFind forced_paths(n);
+    std::queue<int> pending;
+    for (int v = 0; v < n; v++) {
+        if (neighbours[v].size() == 2) pending.push(v);
+    }
+
+    bool changed = true;
+    while (changed) {
+        while (!pending.empty()) {
+            int v = pending.front();
+            pending.pop();
+
+            if (neighbours[v].size() < 2) return finish("vertex with degree below 2 after reductions");
+
+            if (neighbours[v].size() == 2) {
+                for (int w : neighbours[v]) {
+                    if (forced[v].count(w)) continue;
+                    forced[v].insert(w);
+                    forced[w].insert(v);
+                    report.forced_edges.push_back(std::make_pair(std::min(v, w), std::max(v, w)));
+
+                    // a forced edge that closes a cycle before all vertices are in it rules out any tour
+                    if (!forced_paths.unite(v, w) && (int)report.forced_edges.size() < n) {
+                        return finish("forced edges close a subtour");
+                    }
+                    if (forced[w].size() > 2) return finish("vertex with more than two forced edges");
+                    if (forced[w].size() == 2 && neighbours[w].size() > 2) pending.push(w);
+                }
+            }
+
+            // a vertex with two forced edges cannot use any other edge
+            if (forced[v].size() == 2 && neighbours[v].size() > 2) {
+                std::vector<int> dominated;
+                for (int w : neighbours[v]) {
+                    if (!forced[v].count(w)) dominated.push_back(w);
+                }
+                for (int w : dominated) {
+                    neighbours[v].erase(w);
+                    neighbours[w].erase(v);
+                    removeEdge(v, w);
+                    report.removed_edges++;
+                    if (neighbours[w].size() <= 2) pending.push(w);
+                }
+            }
+        }
+
+        // an edge joining two vertices of the same forced path would close a subtour
+        changed = false;
+        for (int v = 0; v < n; v++) {
+            std::vector<int> dominated;
+            for (int w : neighbours[v]) {
+                if (v < w && !forced[v].count(w) && forced_paths.connected(v, w) && forced_paths.setSize(v) < n) {
+                    dominated.push_back(w);
+                }
+            }
+            for (int w : dominated) {
+                neighbours[v].erase(w);
+                neighbours[w].erase(v);
+                removeEdge(v, w);
+                report.removed_edges++;
+                pending.push(v);
+                pending.push(w);
+                changed = true;
+            }
+        }
+    }
+
+    return finish("");
+}
@@ -0,0 +1,106 @@
+#include "utils/graph.h"
+
+#include <chrono>
+#include <random>
+#include <thread>
+
+/// @brief Calcula um perfil rápido do grafo: número de vértices e de arestas, densidade, grau mínimo (vizinhos
+/// distintos), se tem coordenadas e a fração de triplos amostrados que violam a desigualdade triangular.
+/// Cada amostra escolhe um vértice v e dois vizinhos u e w (ou dois vértices quaisquer, se v tiver menos de dois
+/// vizinhos e o grafo tiver coordenadas) e compara custo(u, w) com custo(u, v) + custo(v, w), usando a regra de
+/// travelCost: o peso da aresta ou, sem aresta, a distância de haversine. Sem aresta nem coordenadas o custo é
+/// desconhecido e a amostra não conta.
+/// As amostras são repartidas pelas threads, cada uma com a sua semente fixa, pelo que o resultado é reprodutível.
+/// Esta função tem complexidade O(V + S * grau máximo / T), onde S é o número de amostras e T o número de threads.
+/// @param samples Número de triplos a amostrar.
+/// @param num_threads Número de threads.
+/// @return Perfil do grafo e o tempo gasto a calculá-lo.
+GraphProfile Graph::profile(int samples, int num_threads) const {
+    auto start = std::chrono::steady_clock::now();
+    int n = vertices.size();
+    num_threads = std::max(1, num_threads);
+
+    GraphProfile profile;
+    profile.vertices = n;
+    profile.threads = num_threads;
+    profile.coordinates = false;
+    profile.min_degree = n > 0 ? std::numeric_limits<int>::max() : 0;
+
+    // distinct neighbours, without self loops
+    long long degrees = 0;
+    std::vector<int> seen(n, -1);
+    for (const auto& vertex : vertices) {
+        int degree = 0;
+        for (const edgeNode& edge : vertex.second.adj) {
+            if (edge.vertex != vertex.first && seen[edge.vertex] != vertex.first) {
+                seen[edge.vertex] = vertex.first;
+                degree++;
+            }
+        }
+        degrees += degree;
+        profile.min_degree = std::min(profile.min_degree, degree);
+        if (vertex.second.lat != 0.0 || vertex.second.longi != 0.0) profile.coordinates = true;
+    }
+    // addEdge stores both directions when directed is set, so each edge is then counted at both ends
+    double pairs = (double)n * (n - 1) / (directed ? 2.0 : 1.0);
+    profile.edges = directed ? degrees / 2 : degrees;
+    profile.density = pairs > 0 ? profile.edges / pairs : 0.0;
+    profile.complete = n > 1 && profile.min_degree >= n - 1;
+
+    // cost by the travelCost rule; false when there is no edge and no coordinates to fall back to
+    auto cost = [this, &profile](int a, int b, double& d) {
+        const vertexNode& origin = vertices.at(a);
+        for (const edgeNode& edge : origin.adj) {
+            if (edge.vertex == b) {
+                d = edge.distance;
+                return true;
+            }
+        }
+        if (!profile.coordinates) return false;
+        const vertexNode& dest = vertices.at(b);
+        d = haversine(origin.lat, origin.longi, dest.lat, dest.longi);
+        return true;
+    };
+
+    std::vector<long long> triangles(num_threads, 0), violations(num_threads, 0);
+    if (n >= 3) {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < num_threads; t++) {
+            workers.emplace_back([&, t]() {
+                std::mt19937 rng(12345 + t);
+                std::uniform_int_distribution<int> pick(0, n - 1);
+                for (int s = t; s < samples; s += num_threads) {
+                    int v = pick(rng), u, w;
+                    const std::vector<edgeNode>& adj = vertices.at(v).adj;
+                    if (adj.size() >= 2) {
+                        std::uniform_int_distribution<int> neighbour(0, adj.size() - 1);
+                        u = adj[neighbour(rng)].vertex;
+                        w = adj[neighbour(rng)].vertex;
+                    } else if (profile.coordinates) {
+                        u = pick(rng);
+                        w = pick(rng);
+                    } else {
+                        continue;
+                    }
+                    if (u == v || w == v || u == w) continue;
+
+                    double uv, vw, uw;
+                    if (!cost(u, v, uv) || !cost(v, w, vw) || !cost(u, w, uw)) continue;
+                    triangles[t]++;
+                    if (uw > (uv + vw) * (1.0 + 1e-9) + 1e-9) violations[t]++;
+                }
+            });
+        }
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    profile.triangles = 0;
+    profile.violations = 0;
+    for (int t = 0; t < num_threads; t++) {
+        profile.triangles += triangles[t];
+        profile.violations += violations[t];
+    }
+    profile.violation_rate = profile.triangles > 0 ? (double)profile.violations / profile.triangles : 0.0;
+    profile.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return profile;
+}
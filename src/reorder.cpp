@@ -0,0 +1,77 @@
+#include "utils/graph.h"
+#include "utils/space_filling_curve.h"
+
+/// @brief Calcula uma ordem dos vértices que preserva a localidade.
+/// Com coordenadas, os vértices são ordenados pela posição na curva de Hilbert; sem coordenadas é usada a ordem
+/// reverse Cuthill-McKee (BFS a partir de um vértice de grau mínimo, vizinhos por grau crescente, ordem invertida).
+/// Esta função tem complexidade O(V log V) com coordenadas e O(V + E log E) sem coordenadas.
+/// @return Vetor em que a posição i tem o vértice que passa a ter o número i.
+std::vector<int> Graph::localityOrder() const {
+    int n = vertices.size();
+    std::vector<int> order(n);
+    for (int v = 0; v < n; v++) order[v] = v;
+
+    if (hasCoordinates()) {
+        std::vector<double> xs(n), ys(n);
+        for (int v = 0; v < n; v++) {
+            xs[v] = vertices.at(v).longi;
+            ys[v] = vertices.at(v).lat;
+        }
+        std::vector<uint64_t> keys = hilbertIndices(xs, ys);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return keys[a] < keys[b]; });
+        return order;
+    }
+
+    // reverse Cuthill-McKee, one BFS per connected component
+    std::vector<int> degree(n);
+    for (int v = 0; v < n; v++) degree[v] = vertices.at(v).adj.size();
+    std::vector<int> by_degree = order;
+    std::stable_sort(by_degree.begin(), by_degree.end(), [&](int a, int b) { return degree[a] < degree[b]; });
+
+    std::vector<bool> visited(n, false);
+    order.clear();
+    for (int root : by_degree) {
+        if (visited[root]) continue;
+        size_t head = order.size();
+        order.push_back(root);
+        visited[root] = true;
+
+        while (head < order.size()) {
+            int u = order[head++];
+            std::vector<int> next;
+            for (const edgeNode& edge : vertices.at(u).adj) {
+                if (!visited[edge.vertex]) {
+                    visited[edge.vertex] = true;
+                    next.push_back(edge.vertex);
+                }
+            }
+            std::stable_sort(next.begin(), next.end(), [&](int a, int b) { return degree[a] < degree[b]; });
+            order.insert(order.end(), next.begin(), next.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+/// @brief Renumera os vértices do grafo.
+/// O vértice order[i] passa a ser o vértice i; as listas de adjacências são atualizadas e o mapa de vértices é
+/// reconstruído pela nova ordem, para que vértices com números próximos fiquem também próximos em memória.
+/// Esta função tem complexidade O(V + E).
+/// @param order Permutação dos vértices 0..V-1 (posição i tem o vértice que passa a ter o número i).
+void Graph::renumber(const std::vector<int>& order) {
+    int n = order.size();
+    std::vector<int> new_id(n);
+    for (int i = 0; i < n; i++) new_id[order[i]] = i;
+
+    std::unordered_map<int, vertexNode> renumbered;
+    renumbered.reserve(n);
+    for (int i = 0; i < n; i++) {
+        vertexNode node = std::move(vertices[order[i]]);
+        node.vertex = i;
+        for (edgeNode& edge : node.adj) {
+            edge.vertex = new_id[edge.vertex];
+        }
+        renumbered.emplace(i, std::move(node));
+    }
+    vertices = std::move(renumbered);
+}
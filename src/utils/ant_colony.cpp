@@ -0,0 +1,247 @@
+#include "ant_colony.h"
+#include "tour.h"
+
+#include <cmath>
+#include <limits>
+#include <new>
+
+/// @brief Reserva uma matriz n*n alinhada a ANT_COLONY_ALIGNMENT bytes, com todas as linhas alinhadas.
+/// @param n Número de linhas e colunas.
+/// @param value Valor inicial de todos os elementos.
+AlignedMatrix::AlignedMatrix(int n, float value) : n(n) {
+    size_t per_line = ANT_COLONY_ALIGNMENT / sizeof(float);
+    stride = (n + per_line - 1) / per_line * per_line;
+    size_t bytes = std::max<size_t>(ANT_COLONY_ALIGNMENT, (size_t)n * stride * sizeof(float));
+    data.reset(static_cast<float*>(::operator new(bytes, std::align_val_t(ANT_COLONY_ALIGNMENT))));
+    std::fill(data.get(), data.get() + bytes / sizeof(float), value);
+}
+
+size_t AlignedMatrix::memoryFootprint() const {
+    return sizeof(AlignedMatrix) + std::max<size_t>(ANT_COLONY_ALIGNMENT, size() * sizeof(float));
+}
+
+/// @brief Prepara o MAX-MIN Ant System: listas de candidatos e matriz de heurística (1/d)^beta.
+/// @param dist Matriz de distâncias n*n (row-major), que tem de continuar válida durante a execução.
+/// @param n Número de cidades.
+/// @param params Parâmetros do algoritmo.
+AntColony::AntColony(const std::vector<double>& dist, int n, const AntColonyParams& params) :
+    dist(dist),
+    n(n),
+    params(params),
+    pheromone(n, 0.0f),
+    heuristic(n, 0.0f),
+    choice(n, 0.0f) {
+    this->params.ants = std::max(1, params.ants);
+    this->params.threads = std::max(1, std::min(params.threads, this->params.ants));
+    this->params.candidates = std::max(1, std::min(params.candidates, n - 1));
+
+    for (int i = 0; i < n; i++) {
+        float* row = heuristic.row(i);
+        for (int j = 0; j < n; j++) {
+            double d = std::max(dist[(size_t)i * n + j], 1e-9);
+            row[j] = i == j ? 0.0f : (float)std::pow(1.0 / d, params.beta);
+        }
+    }
+    buildCandidates();
+}
+
+/// @brief Memória das listas de candidatos e das três matrizes alinhadas (a matriz de distâncias pertence a quem a
+/// passou ao construtor).
+size_t AntColony::memoryFootprint() const {
+    size_t bytes = sizeof(AntColony) - 3 * sizeof(AlignedMatrix) + candidates.capacity() * sizeof(std::vector<int>);
+    for (const std::vector<int>& list : candidates) bytes += list.capacity() * sizeof(int);
+    return bytes + pheromone.memoryFootprint() + heuristic.memoryFootprint() + choice.memoryFootprint();
+}
+
+/// @brief Custo de um ciclo na matriz de distâncias.
+double AntColony::tourCost(const std::vector<int>& path) const {
+    double total = 0.0;
+    for (int i = 0; i < n; i++) {
+        total += dist[(size_t)path[i] * n + path[(i + 1) % n]];
+    }
+    return total;
+}
+
+/// @brief Calcula, para cada cidade, as params.candidates cidades mais próximas.
+/// Esta função tem complexidade O(n^2 log k).
+void AntColony::buildCandidates() {
+    candidates.assign(n, {});
+    std::vector<int> order(n);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) order[j] = j;
+        std::swap(order[i], order[n - 1]);
+        const double* row = &dist[(size_t)i * n];
+        int k = params.candidates;
+        std::partial_sort(order.begin(), order.begin() + k, order.end() - 1, [row](int a, int b) { return row[a] < row[b]; });
+        candidates[i].assign(order.begin(), order.begin() + k);
+    }
+}
+
+/// @brief Recalcula choice = feromona * heurística em toda a matriz.
+/// As três matrizes estão alinhadas e têm o mesmo enchimento, pelo que o ciclo é vetorizado pelo compilador.
+void AntColony::updateChoice() {
+    float* __restrict out = static_cast<float*>(__builtin_assume_aligned(choice.begin(), ANT_COLONY_ALIGNMENT));
+    const float* __restrict tau = static_cast<const float*>(__builtin_assume_aligned(pheromone.begin(), ANT_COLONY_ALIGNMENT));
+    const float* __restrict eta = static_cast<const float*>(__builtin_assume_aligned(heuristic.begin(), ANT_COLONY_ALIGNMENT));
+    size_t size = choice.size();
+    for (size_t i = 0; i < size; i++) {
+        out[i] = tau[i] * eta[i];
+    }
+}
+
+/// @brief Evapora a feromona de todas as arestas, sem descer abaixo de tau_min (vetorizado pelo compilador).
+/// @param tau_min Limite inferior da feromona.
+void AntColony::evaporate(float tau_min) {
+    float* __restrict tau = static_cast<float*>(__builtin_assume_aligned(pheromone.begin(), ANT_COLONY_ALIGNMENT));
+    float keep = (float)(1.0 - params.rho);
+    size_t size = pheromone.size();
+    for (size_t i = 0; i < size; i++) {
+        float value = tau[i] * keep;
+        tau[i] = value < tau_min ? tau_min : value;
+    }
+}
+
+/// @brief Deposita feromona nas arestas de um ciclo, nos dois sentidos, sem passar tau_max.
+/// @param path Ciclo.
+/// @param cost Custo do ciclo (a quantidade depositada é 1 / cost).
+/// @param tau_max Limite superior da feromona.
+void AntColony::deposit(const std::vector<int>& path, double cost, float tau_max) {
+    float amount = (float)(1.0 / cost);
+    for (int i = 0; i < n; i++) {
+        int u = path[i], v = path[(i + 1) % n];
+        float value = std::min(tau_max, pheromone.row(u)[v] + amount);
+        pheromone.row(u)[v] = value;
+        pheromone.row(v)[u] = value;
+    }
+}
+
+/// @brief Constrói o ciclo de uma formiga.
+/// Em cada passo o próximo vértice é sorteado entre os candidatos por visitar, com probabilidade proporcional a
+/// choice; se já estiverem todos visitados, é escolhido o vértice por visitar com maior choice.
+/// Esta função tem complexidade O(n * k) mais O(n) por passo sem candidatos livres.
+/// @param path Vetor onde é escrito o ciclo.
+/// @param visited Vetor auxiliar com n posições.
+/// @param rng Gerador de números aleatórios da thread.
+void AntColony::constructTour(std::vector<int>& path, std::vector<char>& visited, std::mt19937& rng) const {
+    std::fill(visited.begin(), visited.end(), 0);
+    path.clear();
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    int current = std::uniform_int_distribution<int>(0, n - 1)(rng);
+    path.push_back(current);
+    visited[current] = 1;
+
+    std::vector<double> weights(params.candidates);
+    while ((int)path.size() < n) {
+        const float* row = choice.row(current);
+        const std::vector<int>& cand = candidates[current];
+
+        double total = 0.0;
+        for (size_t c = 0; c < cand.size(); c++) {
+            weights[c] = visited[cand[c]] ? 0.0 : row[cand[c]];
+            total += weights[c];
+        }
+
+        int next = -1;
+        if (total > 0.0) {
+            double r = uniform(rng) * total;
+            for (size_t c = 0; c < cand.size(); c++) {
+                r -= weights[c];
+                if (weights[c] > 0.0 && r <= 0.0) {
+                    next = cand[c];
+                    break;
+                }
+            }
+        }
+        if (next == -1) {
+            float best = -1.0f;
+            for (int v = 0; v < n; v++) {
+                if (!visited[v] && row[v] > best) {
+                    best = row[v];
+                    next = v;
+                }
+            }
+        }
+
+        path.push_back(next);
+        visited[next] = 1;
+        current = next;
+    }
+}
+
+/// @brief Melhora um ciclo com 2-opt sobre as listas de candidatos.
+/// @param path Ciclo, substituído pelo ciclo melhorado.
+/// @param cost Custo do ciclo, atualizado.
+void AntColony::improve(std::vector<int>& path, double& cost) const {
+    if (n < 5) return;
+    std::unique_ptr<Tour> tour = makeTour(path);
+    twoOptMoves(*tour, path[0], candidates, [&](int u, int v) { return dist[(size_t)u * n + v]; }, cost, 0.0);
+    path = tour->toVector(path[0]);
+}
+
+/// @brief Corre o MAX-MIN Ant System até params.max_iterations iterações ou params.max_seconds segundos.
+/// Em cada iteração as formigas são repartidas pelas threads, a melhor formiga da iteração é opcionalmente melhorada
+/// com 2-opt, a feromona evapora e a melhor formiga da iteração (ou, a cada 10 iterações, a melhor global) deposita.
+/// @param initial_path Ciclo inicial, usado para definir os limites da feromona.
+/// @return Melhor ciclo encontrado, número de iterações e ciclos construídos, e o tempo gasto.
+AntColonyResult AntColony::run(const std::vector<int>& initial_path) {
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&]() { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+
+    AntColonyResult result;
+    result.path = initial_path;
+    result.cost = tourCost(initial_path);
+    result.iterations = 0;
+    result.tours = 0;
+    result.best_iteration = 0;
+
+    double p_root = std::pow(params.p_best, 1.0 / n);
+    double average_choices = std::max(2.0, params.candidates / 2.0);
+    float tau_max = 0.0f, tau_min = 0.0f;
+    auto update_limits = [&]() {
+        tau_max = (float)(1.0 / (params.rho * result.cost));
+        tau_min = (float)(tau_max * (1.0 - p_root) / ((average_choices - 1.0) * p_root));
+    };
+    update_limits();
+    std::fill(pheromone.begin(), pheromone.begin() + pheromone.size(), tau_max);
+
+    std::vector<std::vector<int>> paths(params.ants);
+    std::vector<double> costs(params.ants);
+
+    while ((params.max_iterations <= 0 || result.iterations < params.max_iterations) &&
+           (params.max_seconds <= 0 || elapsed() < params.max_seconds)) {
+        int iteration = result.iterations++;
+        updateChoice();
+
+        auto work = [&](int t) {
+            std::mt19937 rng(params.seed + (unsigned)iteration * params.threads + t);
+            std::vector<char> visited(n);
+            for (int a = t; a < params.ants; a += params.threads) {
+                constructTour(paths[a], visited, rng);
+                costs[a] = tourCost(paths[a]);
+            }
+        };
+        std::vector<std::thread> workers;
+        for (int t = 1; t < params.threads; t++) workers.emplace_back(work, t);
+        work(0);
+        for (std::thread& worker : workers) worker.join();
+        result.tours += params.ants;
+
+        int best = std::min_element(costs.begin(), costs.end()) - costs.begin();
+        if (params.local_search) improve(paths[best], costs[best]);
+
+        if (costs[best] < result.cost - 1e-9) {
+            result.cost = costs[best];
+            result.path = paths[best];
+            result.best_iteration = result.iterations;
+            update_limits();
+        }
+
+        evaporate(tau_min);
+        if (iteration % 10 == 9) deposit(result.path, result.cost, tau_max);
+        else deposit(paths[best], costs[best], tau_max);
+    }
+
+    result.seconds = elapsed();
+    return result;
+}
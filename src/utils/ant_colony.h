@@ -0,0 +1,97 @@
+#ifndef PROJETO2DA_ANT_COLONY_H
+#define PROJETO2DA_ANT_COLONY_H
+
+#include <vector>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <new>
+
+// alinhamento das matrizes de feromona e de heurística (linha de cache, e largura de um registo AVX-512)
+#define ANT_COLONY_ALIGNMENT 64
+
+// parâmetros do MAX-MIN Ant System
+struct AntColonyParams {
+    int ants = 25;
+    int candidates = 15;          // tamanho das listas de candidatos
+    int max_iterations = 1000;    // 0 para não limitar
+    double max_seconds = 10.0;    // 0 para não limitar
+    double rho = 0.02;            // taxa de evaporação
+    double beta = 2.0;            // peso da heurística 1/d (o peso da feromona é 1)
+    double p_best = 0.05;         // probabilidade de construir o melhor ciclo na convergência (define tau_min)
+    bool local_search = false;    // 2-opt sobre a melhor formiga de cada iteração
+    int threads = 1;
+    unsigned seed = 1;
+};
+
+// resultado de uma execução do MAX-MIN Ant System
+struct AntColonyResult {
+    std::vector<int> path;
+    double cost;
+    int iterations;
+    long long tours;        // ciclos construídos pelas formigas
+    double seconds;
+    int best_iteration;     // iteração em que o melhor ciclo foi encontrado
+};
+
+// matriz n*n de floats alinhada, em row-major
+class AlignedMatrix {
+public:
+    AlignedMatrix(int n, float value);
+
+    float* row(int i) { return data.get() + (size_t)i * stride; }
+    const float* row(int i) const { return data.get() + (size_t)i * stride; }
+
+    // todos os elementos, incluindo o enchimento no fim de cada linha
+    float* begin() { return data.get(); }
+    size_t size() const { return (size_t)n * stride; }
+
+    size_t memoryFootprint() const;
+
+private:
+    // memória reservada pelo operator new alinhado, para que passe pelas contagens de MemStats
+    struct Free { void operator()(float* p) const { ::operator delete(p, std::align_val_t(ANT_COLONY_ALIGNMENT)); } };
+
+    int n;
+    size_t stride; // colunas por linha, arredondado para múltiplos do alinhamento
+    std::unique_ptr<float[], Free> data;
+};
+
+// MAX-MIN Ant System sobre uma matriz de distâncias completa: as formigas constroem ciclos em paralelo a partir das
+// listas de candidatos, e só a melhor formiga (da iteração ou global) deposita feromona, limitada a [tau_min, tau_max]
+class AntColony {
+public:
+    AntColony(const std::vector<double>& dist, int n, const AntColonyParams& params);
+
+    // initial_path: ciclo usado para inicializar tau_max (por exemplo, do vizinho mais próximo)
+    AntColonyResult run(const std::vector<int>& initial_path);
+
+    size_t memoryFootprint() const;
+
+private:
+    double tourCost(const std::vector<int>& path) const;
+
+    void buildCandidates();
+
+    void updateChoice();
+
+    void constructTour(std::vector<int>& path, std::vector<char>& visited, std::mt19937& rng) const;
+
+    void improve(std::vector<int>& path, double& cost) const;
+
+    void evaporate(float tau_min);
+
+    void deposit(const std::vector<int>& path, double cost, float tau_max);
+
+    const std::vector<double>& dist;
+    int n;
+    AntColonyParams params;
+
+    std::vector<std::vector<int>> candidates;
+    AlignedMatrix pheromone;
+    AlignedMatrix heuristic;  // (1 / d)^beta
+    AlignedMatrix choice;     // feromona * heurística, recalculada em cada iteração
+};
+
+#endif //PROJETO2DA_ANT_COLONY_H
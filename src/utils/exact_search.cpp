@@ -0,0 +1,459 @@
+#include "exact_search.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+namespace {
+
+const char CHECKPOINT_MAGIC[] = "TSPCKPT";
+const uint8_t CHECKPOINT_VERSION = 1;
+
+uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t fnv1a(const std::string& bytes, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ (uint8_t)bytes[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+uint64_t doubleBits(double x) {
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+// the file is little-endian with LEB128 integers, whatever the machine that wrote it
+class Writer {
+public:
+    void fixed(uint64_t x) {
+        for (int i = 0; i < 8; i++) bytes.push_back((char)(x >> (8 * i)));
+    }
+    void varint(uint64_t x) {
+        while (x >= 0x80) {
+            bytes.push_back((char)(x | 0x80));
+            x >>= 7;
+        }
+        bytes.push_back((char)x);
+    }
+    std::string bytes;
+};
+
+class Reader {
+public:
+    Reader(const std::string& bytes, size_t size) : bytes(bytes), size(size) {}
+
+    bool fixed(uint64_t& x) {
+        if (pos + 8 > size) return false;
+        x = 0;
+        for (int i = 0; i < 8; i++) x |= (uint64_t)(uint8_t)bytes[pos++] << (8 * i);
+        return true;
+    }
+    bool varint(uint64_t& x) {
+        x = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= size) return false;
+            uint8_t byte = (uint8_t)bytes[pos++];
+            x |= (uint64_t)(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+    bool done() const { return pos == size; }
+
+private:
+    const std::string& bytes;
+    size_t size;
+    size_t pos = 0;
+};
+
+}
+
+/// @brief Escreve o estado num ficheiro binário compacto.
+/// Os prefixos da fronteira partilham quase sempre o início com o anterior, pelo que cada um guarda só o comprimento
+/// do início comum e os vértices seguintes. O ficheiro é escrito numa cópia temporária e depois renomeado, para que
+/// uma interrupção a meio da escrita nunca estrague o checkpoint anterior.
+/// @param file Caminho do ficheiro.
+/// @return True se o ficheiro foi escrito.
+bool SearchCheckpoint::save(const std::string& file) const {
+    Writer out;
+    out.bytes.append(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC) - 1);
+    out.bytes.push_back((char)CHECKPOINT_VERSION);
+    out.fixed(fingerprint);
+    out.fixed(doubleBits(best_cost));
+    out.varint(best_path.size());
+    for (int v : best_path) out.varint(v);
+    out.varint(expanded_nodes);
+    out.fixed(doubleBits(seconds));
+    out.varint(checkpoints);
+    out.varint(frontier.size());
+    const std::vector<int>* previous = nullptr;
+    for (const std::vector<int>& prefix : frontier) {
+        size_t shared = 0;
+        if (previous != nullptr) {
+            while (shared < prefix.size() && shared < previous->size() && prefix[shared] == (*previous)[shared]) shared++;
+        }
+        out.varint(shared);
+        out.varint(prefix.size() - shared);
+        for (size_t i = shared; i < prefix.size(); i++) out.varint(prefix[i]);
+        previous = &prefix;
+    }
+    out.fixed(fnv1a(out.bytes, out.bytes.size()));
+
+    std::string temporary = file + ".tmp";
+    {
+        std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+        if (!stream.write(out.bytes.data(), (std::streamsize)out.bytes.size())) return false;
+    }
+    return std::rename(temporary.c_str(), file.c_str()) == 0;
+}
+
+/// @brief Lê um estado escrito por save.
+/// @param file Caminho do ficheiro.
+/// @return False se o ficheiro não existir, estiver truncado ou corrompido, ou tiver outra versão.
+bool SearchCheckpoint::load(const std::string& file) {
+    std::ifstream stream(file, std::ios::binary);
+    if (!stream.is_open()) return false;
+    std::string bytes((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    size_t header = sizeof(CHECKPOINT_MAGIC);
+    if (bytes.size() < header + 8) return false;
+    if (bytes.compare(0, header - 1, CHECKPOINT_MAGIC) != 0 || (uint8_t)bytes[header - 1] != CHECKPOINT_VERSION) return false;
+    size_t payload = bytes.size() - 8;
+    uint64_t checksum = 0;
+    for (int i = 0; i < 8; i++) checksum |= (uint64_t)(uint8_t)bytes[payload + i] << (8 * i);
+    if (checksum != fnv1a(bytes, payload)) return false;
+
+    std::string body = bytes.substr(header, payload - header);
+    Reader reader(body, body.size());
+
+    uint64_t value, count;
+    SearchCheckpoint state;
+    if (!reader.fixed(state.fingerprint) || !reader.fixed(value)) return false;
+    std::memcpy(&state.best_cost, &value, sizeof(value));
+    if (!reader.varint(count) || count > body.size()) return false;
+    state.best_path.resize(count);
+    for (int& v : state.best_path) {
+        if (!reader.varint(value)) return false;
+        v = (int)value;
+    }
+    if (!reader.varint(value)) return false;
+    state.expanded_nodes = (long long)value;
+    if (!reader.fixed(value)) return false;
+    std::memcpy(&state.seconds, &value, sizeof(value));
+    if (!reader.varint(value)) return false;
+    state.checkpoints = (int)value;
+
+    if (!reader.varint(count) || count > body.size()) return false;
+    state.frontier.resize(count);
+    const std::vector<int>* previous = nullptr;
+    for (std::vector<int>& prefix : state.frontier) {
+        uint64_t shared, tail;
+        if (!reader.varint(shared) || !reader.varint(tail) || tail > body.size()) return false;
+        if (shared > (previous == nullptr ? 0 : previous->size())) return false;
+        if (shared > 0) prefix.assign(previous->begin(), previous->begin() + shared);
+        for (uint64_t i = 0; i < tail; i++) {
+            if (!reader.varint(value)) return false;
+            prefix.push_back((int)value);
+        }
+        previous = &prefix;
+    }
+    if (!reader.done()) return false;
+
+    *this = std::move(state);
+    return true;
+}
+
+/// @brief Prepara a pesquisa exata sobre um grafo, que só é lido.
+/// @param graph Grafo.
+/// @param params Número de threads, limites de paragem e configuração dos checkpoints.
+ExactSearch::ExactSearch(const Graph& graph, const ExactSearchParams& params) :
+    graph(graph),
+    params(params),
+    min_out(graph.cheapestOutgoingEdges()),
+    weights(graph.getNumVertices() <= DENSE_MATRIX_VERTICES ? graph.edgeWeightMatrix() : std::vector<double>()),
+    best_cost(std::numeric_limits<double>::infinity()),
+    suspend(false),
+    cancel(false),
+    gap_reached(false),
+    aborted(false) {
+    this->params.threads = std::max(1, params.threads);
+}
+
+/// @brief Impressão digital do grafo (número de vértices e todas as arestas com os seus pesos), independente da ordem
+/// das listas de adjacências. Um checkpoint só é retomado sobre um grafo com a mesma impressão digital.
+/// Esta função tem complexidade O(V + E).
+uint64_t ExactSearch::fingerprint(const Graph& graph) {
+    int n = graph.getNumVertices();
+    uint64_t hash = mix(n);
+    for (int u = 0; u < n; u++) {
+        for (const edgeNode& edge : graph.getAdjacent(u)) {
+            hash += mix(mix(((uint64_t)u << 32) | (uint32_t)edge.vertex) ^ doubleBits(edge.distance));
+        }
+    }
+    return hash;
+}
+
+/// @brief Estado de uma pesquisa nova: um único prefixo, o vértice 0.
+SearchCheckpoint ExactSearch::initialState() const {
+    SearchCheckpoint state;
+    state.fingerprint = fingerprint(graph);
+    if (graph.getNumVertices() > 0) state.frontier.push_back({0});
+    return state;
+}
+
+double ExactSearch::elapsed() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// @brief Parte prefixos nos seus filhos (os vizinhos por visitar do último vértice), pela ordem da pesquisa, ronda
+/// a ronda, até haver pelo menos target prefixos ou todos terem os vértices todos.
+/// @param graph Grafo.
+/// @param prefixes Prefixos a partir.
+/// @param target Número de prefixos pretendido.
+/// @return Prefixos cujas subárvores cobrem exatamente as dos prefixos dados.
+std::vector<std::vector<int>> ExactSearch::split(const Graph& graph, std::vector<std::vector<int>> prefixes, size_t target) {
+    int n = graph.getNumVertices();
+    bool grew = true;
+    while (prefixes.size() < target && grew) {
+        grew = false;
+        std::vector<std::vector<int>> next;
+        for (std::vector<int>& prefix : prefixes) {
+            if ((int)prefix.size() >= n) {
+                next.push_back(std::move(prefix));
+                continue;
+            }
+            std::vector<bool> visited(n, false);
+            for (int v : prefix) visited[v] = true;
+            for (const edgeNode& edge : graph.getAdjacent(prefix.back())) {
+                if (visited[edge.vertex]) continue;
+                visited[edge.vertex] = true;
+                next.push_back(prefix);
+                next.back().push_back(edge.vertex);
+            }
+            grew = true;
+        }
+        prefixes.swap(next);
+    }
+    return prefixes;
+}
+
+/// @brief Corta a pesquisa com o custo de um ciclo conhecido fora dela; não altera o melhor ciclo devolvido.
+void ExactSearch::tighten(double cost) {
+    double current = best_cost.load();
+    while (cost < current && !best_cost.compare_exchange_weak(current, cost)) {}
+}
+
+/// @brief Pára a pesquisa o mais depressa possível; os prefixos por explorar são descartados.
+void ExactSearch::abort() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        aborted.store(true);
+        cancel.store(true);
+    }
+    changed.notify_all();
+}
+
+/// @brief Propõe um ciclo como o melhor da pesquisa.
+void ExactSearch::offer(double cost, const std::vector<int>& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (cost < best_cost.load()) {
+        best_cost.store(cost);
+        best_path = path;
+        path_cost = cost;
+    }
+}
+
+/// @brief Explora a subárvore de um prefixo com o branch-and-bound.
+/// O custo do prefixo segue, entre cada par de vértices, a aresta mais barata.
+/// @param prefix Caminho a partir do vértice 0.
+/// @param expanded Incrementado com os nós expandidos.
+/// @return Prefixos por explorar se a pesquisa tiver sido suspensa (vazio se a subárvore ficou esgotada).
+std::vector<std::vector<int>> ExactSearch::explore(const std::vector<int>& prefix, long long& expanded) {
+    int n = graph.getNumVertices();
+    std::vector<bool> visited(n, false);
+    double cost = 0.0;
+    for (size_t i = 0; i < prefix.size(); i++) {
+        visited[prefix[i]] = true;
+        if (i == 0) continue;
+        double cheapest = std::numeric_limits<double>::infinity();
+        for (const edgeNode& edge : graph.getAdjacent(prefix[i - 1])) {
+            if (edge.vertex == prefix[i]) cheapest = std::min(cheapest, edge.distance);
+        }
+        if (cheapest == std::numeric_limits<double>::infinity()) return {};
+        cost += cheapest;
+    }
+
+    SearchBound bound;
+    bound.lower_bound = params.lower_bound;
+    bound.gap_threshold = params.gap_threshold;
+    bound.min_out = min_out;
+    bound.weights = weights.empty() ? nullptr : &weights;
+    bound.remaining_min_out = 0.0;
+    bound.expanded_nodes = 0;
+    bound.stop = false;
+    bound.cancel = &cancel;
+    bound.shared_cost = &best_cost;
+    bound.suspend = &suspend;
+    bound.on_improvement = [this](double c, const std::vector<int>& tour) { offer(c, tour); };
+    for (int v = 0; v < n; v++) {
+        if (!visited[v]) bound.remaining_min_out += min_out[v];
+    }
+
+    double min_cost = best_cost.load();
+    std::vector<int> path = prefix;
+    graph.tsp_branch_and_bound(path, visited, min_cost, cost, bound);
+    expanded += bound.expanded_nodes;
+
+    if (bound.stop && !bound.suspended && !cancel.load()) {
+        gap_reached.store(true);
+        cancel.store(true);
+    }
+    return std::move(bound.frontier);
+}
+
+/// @brief Ciclo de uma thread: tira o primeiro prefixo da fila e explora-o; se for suspensa devolve os prefixos por
+/// explorar ao início da fila, para que a ordem da pesquisa se mantenha.
+void ExactSearch::worker() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [this]() { return finished || (!suspend.load() && !queue.empty()); });
+        if (finished) return;
+
+        std::vector<int> prefix = std::move(queue.front());
+        queue.pop_front();
+        active++;
+        lock.unlock();
+
+        long long expanded = 0;
+        std::vector<std::vector<int>> rest = explore(prefix, expanded);
+
+        lock.lock();
+        active--;
+        expanded_nodes += expanded;
+        if (!cancel.load()) {
+            queue.insert(queue.begin(), std::make_move_iterator(rest.begin()), std::make_move_iterator(rest.end()));
+        }
+        changed.notify_all();
+    }
+}
+
+/// @brief Escreve em params.checkpoint_file o estado atual: a fila, o melhor ciclo e os contadores.
+/// Só é chamada com o mutex adquirido e com todas as threads paradas.
+/// @param state Estado com que a execução começou (impressão digital, tempo e checkpoints anteriores).
+bool ExactSearch::writeCheckpoint(SearchCheckpoint& state) {
+    SearchCheckpoint snapshot;
+    snapshot.fingerprint = state.fingerprint;
+    snapshot.best_cost = path_cost;
+    snapshot.best_path = best_path;
+    snapshot.expanded_nodes = expanded_nodes;
+    snapshot.seconds = state.seconds + elapsed();
+    snapshot.checkpoints = state.checkpoints + 1;
+    snapshot.frontier.assign(queue.begin(), queue.end());
+    if (!snapshot.save(params.checkpoint_file)) return false;
+    state.checkpoints++;
+    return true;
+}
+
+/// @brief Corre a pesquisa a partir de um estado (novo ou lido de um checkpoint) até esgotar os prefixos, atingir o
+/// gap pedido ou passar params.time_limit.
+/// Se params.checkpoint_file estiver definido, de params.checkpoint_interval em params.checkpoint_interval segundos
+/// as threads são suspensas, o estado é escrito e a pesquisa continua. Suspender não perde trabalho, e o intervalo
+/// aumenta se a escrita levar mais de CHECKPOINT_MAX_OVERHEAD do tempo entre checkpoints. Quando a pesquisa pára por
+/// tempo o estado final também é escrito; quando termina o ficheiro é apagado.
+/// @param state Estado inicial (initialState ou SearchCheckpoint::load).
+/// @return Melhor ciclo, contadores e o motivo de paragem.
+ExactSearchResult ExactSearch::run(SearchCheckpoint state) {
+    start = std::chrono::steady_clock::now();
+    queue.assign(state.frontier.begin(), state.frontier.end());
+    state.frontier.clear();
+    best_cost.store(state.best_cost);
+    best_path = state.best_path;
+    path_cost = state.best_path.empty() ? std::numeric_limits<double>::infinity() : state.best_cost;
+    expanded_nodes = state.expanded_nodes;
+    if (params.threads > 1) {
+        std::vector<std::vector<int>> prefixes(queue.begin(), queue.end());
+        prefixes = split(graph, std::move(prefixes), (size_t)params.threads * EXACT_SEARCH_PREFIXES_PER_THREAD);
+        queue.assign(prefixes.begin(), prefixes.end());
+    }
+
+    ExactSearchResult result;
+    result.checkpoints = 0;
+    result.checkpoint_seconds = 0.0;
+    result.timed_out = false;
+
+    bool checkpointing = !params.checkpoint_file.empty() && params.checkpoint_interval > 0.0;
+    double interval = params.checkpoint_interval;
+    double next_checkpoint = interval;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < params.threads; t++) threads.emplace_back(&ExactSearch::worker, this);
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto done = [this]() { return (queue.empty() && active == 0) || cancel.load(); };
+        while (true) {
+            double wake = std::numeric_limits<double>::infinity();
+            if (checkpointing) wake = next_checkpoint;
+            if (params.time_limit > 0.0) wake = std::min(wake, params.time_limit);
+            if (wake == std::numeric_limits<double>::infinity()) {
+                changed.wait(lock, done);
+            } else {
+                changed.wait_until(lock, start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(wake)), done);
+            }
+            if (done()) break;
+            double now = elapsed();
+            if (now < wake) continue;
+
+            suspend.store(true);
+            changed.wait(lock, [this]() { return active == 0; });
+            if (params.time_limit > 0.0 && now >= params.time_limit) {
+                result.timed_out = true;
+                break;
+            }
+
+            double before = elapsed();
+            if (writeCheckpoint(state)) result.checkpoints++;
+            double cost = elapsed() - before;
+            result.checkpoint_seconds += cost;
+            interval = std::max(params.checkpoint_interval, cost / CHECKPOINT_MAX_OVERHEAD);
+            next_checkpoint = elapsed() + interval;
+
+            suspend.store(false);
+            changed.notify_all();
+        }
+        finished = true;
+        changed.notify_all();
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    result.cost = path_cost;
+    result.path = best_path;
+    result.expanded_nodes = expanded_nodes;
+    result.gap_reached = gap_reached.load();
+    result.aborted = aborted.load();
+    result.complete = !result.timed_out && !result.gap_reached && !result.aborted;
+    result.frontier_size = result.complete || result.gap_reached ? 0 : queue.size();
+
+    if (!params.checkpoint_file.empty() && !result.aborted) {
+        if (result.timed_out) {
+            double before = elapsed();
+            if (writeCheckpoint(state)) result.checkpoints++;
+            result.checkpoint_seconds += elapsed() - before;
+        } else {
+            std::remove(params.checkpoint_file.c_str());
+        }
+    }
+    result.seconds = state.seconds + elapsed();
+    return result;
+}
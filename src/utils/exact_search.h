@@ -0,0 +1,118 @@
+#ifndef PROJETO2DA_EXACT_SEARCH_H
+#define PROJETO2DA_EXACT_SEARCH_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <limits>
+#include <cstdint>
+
+#include "graph.h"
+
+// intervalo por omissão entre checkpoints da pesquisa exata (segundos)
+#define CHECKPOINT_INTERVAL 60.0
+// fração máxima do tempo de pesquisa gasta em checkpoints; se a escrita for lenta o intervalo aumenta
+#define CHECKPOINT_MAX_OVERHEAD 0.01
+// prefixos iniciais por thread quando a pesquisa começa com várias threads
+#define EXACT_SEARCH_PREFIXES_PER_THREAD 8
+
+// estado de uma pesquisa exata: o que falta explorar é uma lista de prefixos (caminhos a partir do vértice 0), pelo
+// que não depende do número de threads nem da máquina que a suspendeu
+struct SearchCheckpoint {
+    uint64_t fingerprint = 0;                               // identifica o grafo (ExactSearch::fingerprint)
+    double best_cost = std::numeric_limits<double>::infinity();
+    std::vector<int> best_path;
+    long long expanded_nodes = 0;
+    double seconds = 0.0;                                   // tempo de pesquisa acumulado em todas as execuções
+    int checkpoints = 0;                                    // checkpoints escritos
+    std::vector<std::vector<int>> frontier;                 // prefixos por explorar, pela ordem da pesquisa
+
+    bool save(const std::string& file) const;
+    bool load(const std::string& file);
+};
+
+struct ExactSearchParams {
+    int threads = 1;
+    double lower_bound = 0.0;        // limite inferior global, 0 se desconhecido
+    double gap_threshold = 0.0;      // pára quando (UB - LB) / LB <= gap_threshold
+    double time_limit = 0.0;         // suspende a pesquisa ao fim deste tempo (segundos); 0 sem limite
+    std::string checkpoint_file;     // vazio para não escrever checkpoints
+    double checkpoint_interval = CHECKPOINT_INTERVAL;
+};
+
+struct ExactSearchResult {
+    double cost;                     // infinito se não houver ciclo
+    std::vector<int> path;
+    long long expanded_nodes;        // incluindo as execuções anteriores
+    double seconds;                  // incluindo as execuções anteriores
+    bool complete;                   // a pesquisa esgotou todos os prefixos: o ciclo é ótimo
+    bool gap_reached;
+    bool timed_out;
+    bool aborted;
+    size_t frontier_size;            // prefixos por explorar quando a pesquisa parou
+    int checkpoints;                 // checkpoints escritos nesta execução
+    double checkpoint_seconds;       // tempo gasto a escrever checkpoints nesta execução
+};
+
+// branch-and-bound (Graph::tsp_branch_and_bound) sobre uma lista de prefixos partilhada por várias threads, com
+// checkpoints periódicos: as threads suspendem a pesquisa, devolvem os prefixos por explorar e o estado é escrito
+// num ficheiro binário a partir do qual a pesquisa pode continuar
+class ExactSearch {
+public:
+    ExactSearch(const Graph& graph, const ExactSearchParams& params);
+
+    static uint64_t fingerprint(const Graph& graph);
+
+    // estado de uma pesquisa nova (só o prefixo {0})
+    SearchCheckpoint initialState() const;
+
+    ExactSearchResult run(SearchCheckpoint state);
+
+    // parte prefixos nos seus filhos, pela ordem da pesquisa, até haver pelo menos target prefixos (se possível)
+    static std::vector<std::vector<int>> split(const Graph& graph, std::vector<std::vector<int>> prefixes, size_t target);
+
+    // custo de um ciclo encontrado fora desta pesquisa (por exemplo noutro processo), usado só para cortar
+    void tighten(double cost);
+
+    // pára a pesquisa sem guardar o que falta explorar
+    void abort();
+
+private:
+    std::vector<std::vector<int>> explore(const std::vector<int>& prefix, long long& expanded);
+
+    void offer(double cost, const std::vector<int>& path);
+
+    void worker();
+
+    bool writeCheckpoint(SearchCheckpoint& state);
+
+    double elapsed() const;
+
+    const Graph& graph;
+    ExactSearchParams params;
+    std::vector<double> min_out;
+    // matriz de pesos para o corte por árvore geradora (vazia em grafos com mais de DENSE_MATRIX_VERTICES vértices)
+    std::vector<double> weights;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::vector<int>> queue;
+    int active = 0;
+    bool finished = false;
+    long long expanded_nodes = 0;
+    std::vector<int> best_path;
+    double path_cost;                // custo de best_path (best_cost pode ser menor, vindo de tighten)
+
+    std::atomic<double> best_cost;
+    std::atomic<bool> suspend;
+    std::atomic<bool> cancel;
+    std::atomic<bool> gap_reached;
+    std::atomic<bool> aborted;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif //PROJETO2DA_EXACT_SEARCH_H
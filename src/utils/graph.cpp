@@ -1,4 +1,7 @@
 #include "graph.h"
+#include "space_filling_curve.h"
+
+#include <thread>
 
 
 /** Construtor da classe Graph.
@@ -37,30 +40,30 @@ bool Graph::isDirected() const {
 /// @brief Retorna a latitude de um vértice.
 /// @param vertex Vértice a ser consultado.
 /// @return Latitude do vértice.
-double Graph::getLat(int vertex) {
-    return vertices[vertex].lat;
+double Graph::getLat(int vertex) const {
+    return vertices.at(vertex).lat;
 }
 
 /// @brief Retorna a longitude de um vértice.
 /// @param vertex Vértice a ser consultado.
 /// @return Longitude do vértice.
-double Graph::getLongi(int vertex) {
-    return vertices[vertex].longi;
+double Graph::getLongi(int vertex) const {
+    return vertices.at(vertex).longi;
 }
 
 /// @brief Retorna o label de um vértice.
 /// @param vertexID Vértice a ser consultado.
 /// @return Label do vértice.
-std::string Graph::getLabel(int vertexID) {
-    return vertices[vertexID].label;
+std::string Graph::getLabel(int vertexID) const {
+    return vertices.at(vertexID).label;
 }
 
 /// @brief Calcula a distância entre dois vértices.
 /// @param v1 Vértice 1.
 /// @param v2 Vértice 2.
 /// @return Distância entre os vértices.
-double Graph::getDistance(int v1, int v2) {
-    for(auto &edge : vertices[v1].adj) {
+double Graph::getDistance(int v1, int v2) const {
+    for(auto &edge : vertices.at(v1).adj) {
         if(edge.vertex == v2) {
             return edge.distance;
         }
@@ -68,12 +71,35 @@ double Graph::getDistance(int v1, int v2) {
     return 0.0;
 }
 
-/// @brief Retorna o vetor de vértices do grafo.
+/// @brief Retorna a lista de adjacências de um vértice, sem a copiar.
+/// Não altera o grafo, pelo que pode ser chamada por várias threads ao mesmo tempo.
+/// @param vertex Vértice a ser consultado.
+/// @return Arestas que saem do vértice.
+const std::vector<edgeNode>& Graph::getAdjacent(int vertex) const {
+    return vertices.at(vertex).adj;
+}
+
+/// @brief Retorna o vetor de vértices do grafo, sem o copiar.
 /// @return Vetor de vértices do grafo.
-std::unordered_map<int, vertexNode> Graph::getVertices() {
+const std::unordered_map<int, vertexNode>& Graph::getVertices() const {
     return vertices;
 }
 
+/// @brief Estima a memória ocupada pelo grafo.
+/// Conta o objeto, os buckets e nós do mapa de vértices, as labels fora do buffer interno da string e a capacidade
+/// das listas de adjacências. Esta função tem complexidade O(V).
+/// @return Número de bytes.
+size_t Graph::memoryFootprint() const {
+    size_t bytes = sizeof(Graph) + vertices.bucket_count() * sizeof(void*);
+    for (const auto& vertex : vertices) {
+        // each node of the map holds the pair plus the pointer to the next node
+        bytes += sizeof(std::pair<const int, vertexNode>) + sizeof(void*);
+        if (vertex.second.label.capacity() > 15) bytes += vertex.second.label.capacity() + 1;
+        bytes += vertex.second.adj.capacity() * sizeof(edgeNode);
+    }
+    return bytes;
+}
+
 /** Adiciona um vertice ao grafo.
  * Este método tem complexidade de tempo O(1).
  */
@@ -104,7 +130,7 @@ bool Graph::addVertex(int vertex, double lat, double longi, std::string label) {
 }
 
 //returns true if vertex exists and false otherwise
-bool Graph::vertexExists(int vertexID){
+bool Graph::vertexExists(int vertexID) const{
     return vertices.count(vertexID) != 0;
 }
 
@@ -153,7 +179,7 @@ void Graph::addEdge(int v1, int v2, double distance) {
 /** Imprime o grafo.
  * Este método tem complexidade de tempo O(V + E), onde V é o número de vértices e E é o número de arestas.
  */
-void Graph::printGraph()
+void Graph::printGraph() const
 {
     for (auto &vertex : vertices) {
         std::cout << vertex.first << " (" << vertex.second.lat << ", " << vertex.second.longi << ") " << vertex.second.label << ": ";
@@ -170,7 +196,7 @@ void Graph::printGraph()
  * @param parent Referência para um vetor que armazenará os o índice pai de cada vértice na MST.
  * @return Vetor de pares de inteiros que representam as arestas da MST.
  */
-std::vector<std::pair<int, int>> Graph::primMST(std::vector<int>& parent) {
+std::vector<std::pair<int, int>> Graph::primMST(std::vector<int>& parent) const {
     std::vector<double> key(vertices.size(), std::numeric_limits<double>::max());
     std::vector<bool> inMST(vertices.size(), false);
     int startVertex = 0;  // Starting vertex for MST
@@ -190,7 +216,7 @@ std::vector<std::pair<int, int>> Graph::primMST(std::vector<int>& parent) {
         inMST[u] = true;
 
         // Update key and parent index of adjacent vertices
-        for (const edgeNode &edge: vertices[u].adj) {
+        for (const edgeNode &edge: vertices.at(u).adj) {
             int v = edge.vertex;
             double weight = edge.distance;
 
@@ -203,8 +229,6 @@ std::vector<std::pair<int, int>> Graph::primMST(std::vector<int>& parent) {
     }
 
     std::vector<std::pair<int, int>> mst;
-    // Print the MST
-    std::cout << "Minimum Spanning Tree:" << std::endl;
     for (int i = 1; i < vertices.size(); ++i) {
         // Fill the mst
         mst.push_back(std::make_pair(parent[i], i));
@@ -221,7 +245,7 @@ std::vector<std::pair<int, int>> Graph::primMST(std::vector<int>& parent) {
 /// @param visited Vetor de visitados.
 /// @param cityStack Pilha de cidades.
 /// @param path Vetor de caminho.
-void Graph::dfs(int current, const std::vector<int> &parent, std::vector<bool> &visited, std::stack<int> &cityStack, std::vector<int> &path) {
+void Graph::dfs(int current, const std::vector<int> &parent, std::vector<bool> &visited, std::stack<int> &cityStack, std::vector<int> &path) const {
     visited[current] = true;
     cityStack.push(current);
 
@@ -244,7 +268,7 @@ void Graph::dfs(int current, const std::vector<int> &parent, std::vector<bool> &
 /// @brief Calcula a distância total de um caminho.
 /// @param path Vetor de inteiros, representando o caminho.
 /// @return Retorna a distância total do caminho.
-double Graph::calculateTotalDistance(const std::vector<int> &path) {
+double Graph::calculateTotalDistance(const std::vector<int> &path) const {
     double totalDistance = 0.0;
 
     // Calculate the total distance
@@ -253,11 +277,11 @@ double Graph::calculateTotalDistance(const std::vector<int> &path) {
         int v2 = path[i + 1];
 
         if(!check_if_nodes_are_connected(v1, v2)){
-            totalDistance += haversine(vertices[v1].lat, vertices[v1].longi, vertices[v2].lat, vertices[v2].longi);
+            totalDistance += haversine(vertices.at(v1).lat, vertices.at(v1).longi, vertices.at(v2).lat, vertices.at(v2).longi);
             continue;
         }
 
-        for (const edgeNode& edge : vertices[v1].adj) {
+        for (const edgeNode& edge : vertices.at(v1).adj) {
             if (edge.vertex == v2) {
                 totalDistance += edge.distance;
                 break;
@@ -268,10 +292,10 @@ double Graph::calculateTotalDistance(const std::vector<int> &path) {
     //add final distance to total distance
     int final_city = path.back();
     if(!check_if_nodes_are_connected(final_city, path[0])){
-        totalDistance += haversine(vertices[final_city].lat, vertices[final_city].longi, vertices[path[0]].lat, vertices[path[0]].longi);
+        totalDistance += haversine(vertices.at(final_city).lat, vertices.at(final_city).longi, vertices.at(path[0]).lat, vertices.at(path[0]).longi);
     }
     else{
-        for(const edgeNode& edge : vertices[final_city].adj){
+        for(const edgeNode& edge : vertices.at(final_city).adj){
             if(edge.vertex == path[0]){
                 totalDistance += edge.distance;
                 break;
@@ -287,7 +311,7 @@ double Graph::calculateTotalDistance(const std::vector<int> &path) {
 /// @param v1 Vértice 1.
 /// @param v2 Vértice 2.
 /// @return Retorna true se os vértices são conectados, false caso contrário.
-bool Graph::check_if_nodes_are_connected(int v1, int v2){
+bool Graph::check_if_nodes_are_connected(int v1, int v2) const{
     int index_v1;
     //iterate through vertices to find index of v1
     for(auto it = vertices.begin(); it != vertices.end(); ++it){
@@ -297,7 +321,7 @@ bool Graph::check_if_nodes_are_connected(int v1, int v2){
         }
     }
 
-    for(const edgeNode& edge : vertices[index_v1].adj){
+    for(const edgeNode& edge : vertices.at(index_v1).adj){
         if(edge.vertex == v2){
             return true;
         }
@@ -341,7 +365,7 @@ double Graph::haversine(double lat1, double lon1, double lat2, double lon2) {
  * @param start_vertex Índice do vértice inicial.
  * @return Retorna um vetor de inteiros, representando o caminho vizinho mais próximo.
  */
-std::vector<int> Graph::nearestNeighbour(int start_vertex) {
+std::vector<int> Graph::nearestNeighbour(int start_vertex) const {
     std::vector<int> path;
     std::vector<bool> visited(vertices.size(), false);
 
@@ -353,7 +377,7 @@ std::vector<int> Graph::nearestNeighbour(int start_vertex) {
         int next_vertex = -1;
         double min_distance = std::numeric_limits<double>::max();
 
-        for (const edgeNode& edge : vertices[current_vertex].adj) {
+        for (const edgeNode& edge : vertices.at(current_vertex).adj) {
             if (!visited[edge.vertex] && edge.distance < min_distance) {
                 next_vertex = edge.vertex;
                 min_distance = edge.distance;
@@ -372,4 +396,96 @@ std::vector<int> Graph::nearestNeighbour(int start_vertex) {
     return path;
 }
 
+/// @brief Constrói um ciclo que visita os vértices pela ordem da curva de Hilbert sobre (longitude, latitude).
+/// Não consulta distâncias: os índices são calculados em paralelo, cada thread ordena um bloco e os blocos ordenados
+/// são depois fundidos dois a dois.
+/// Esta função tem complexidade O(V log V / T + V log T).
+/// @param num_threads Número de threads.
+/// @return Ciclo como permutação de todos os vértices.
+std::vector<int> Graph::spaceFillingCurveTour(int num_threads) const {
+    int n = vertices.size();
+    std::vector<double> xs(n), ys(n);
+    for (int v = 0; v < n; v++) {
+        const vertexNode& node = vertices.at(v);
+        xs[v] = node.longi;
+        ys[v] = node.lat;
+    }
+    std::vector<uint64_t> keys = hilbertIndices(xs, ys, num_threads);
+
+    std::vector<std::pair<uint64_t, int>> order(n);
+    for (int v = 0; v < n; v++) order[v] = std::make_pair(keys[v], v);
+
+    num_threads = std::max(1, std::min(num_threads, n / 4096 + 1));
+    std::vector<size_t> bounds;
+    for (int t = 0; t <= num_threads; t++) bounds.push_back((size_t)n * t / num_threads);
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < num_threads; t++) {
+        workers.emplace_back([&order, &bounds, t]() { std::sort(order.begin() + bounds[t], order.begin() + bounds[t + 1]); });
+    }
+    std::sort(order.begin(), order.begin() + bounds[1]);
+    for (std::thread& worker : workers) worker.join();
+
+    // merge neighbouring sorted blocks until only one is left
+    for (size_t width = 1; width < bounds.size() - 1; width *= 2) {
+        for (size_t i = 0; i + width < bounds.size() - 1; i += 2 * width) {
+            size_t last = std::min(i + 2 * width, bounds.size() - 1);
+            std::inplace_merge(order.begin() + bounds[i], order.begin() + bounds[i + width], order.begin() + bounds[last]);
+        }
+    }
 
+    std::vector<int> path(n);
+    for (int i = 0; i < n; i++) path[i] = order[i].second;
+    return path;
+}
+
+
+
+/// @brief Calcula o custo de ir de um vértice a outro.
+/// Usa a aresta se existir e, caso contrário, a distância haversine entre os vértices (tal como calculateTotalDistance).
+/// Esta função tem complexidade de tempo O(grau(v1)).
+/// @param v1 Vértice de origem.
+/// @param v2 Vértice de destino.
+/// @return Custo de ir de v1 a v2.
+double Graph::travelCost(int v1, int v2) const {
+    const vertexNode& origin = vertices.at(v1);
+    for (const edgeNode& edge : origin.adj) {
+        if (edge.vertex == v2) {
+            return edge.distance;
+        }
+    }
+    const vertexNode& dest = vertices.at(v2);
+    return haversine(origin.lat, origin.longi, dest.lat, dest.longi);
+}
+
+/// @brief Constrói a matriz de distâncias do grafo, em formato row-major (n*n).
+/// Cada entrada (i, j) é travelCost(i, j), pelo que o custo de qualquer caminho calculado sobre a matriz
+/// coincide com o de calculateTotalDistance.
+/// Esta função tem complexidade de tempo O(V^2 + V*E).
+/// @return Vetor com V*V distâncias.
+std::vector<double> Graph::buildDistanceMatrix() const {
+    int n = vertices.size();
+    std::vector<double> dist((size_t)n * n, 0.0);
+    std::vector<bool> adjacent(n, false);
+
+    for (int i = 0; i < n; i++) {
+        const vertexNode& origin = vertices.at(i);
+        double* row = &dist[(size_t)i * n];
+
+        for (const edgeNode& edge : origin.adj) {
+            row[edge.vertex] = edge.distance;
+            adjacent[edge.vertex] = true;
+        }
+        for (int j = 0; j < n; j++) {
+            if (j != i && !adjacent[j]) {
+                const vertexNode& dest = vertices.at(j);
+                row[j] = haversine(origin.lat, origin.longi, dest.lat, dest.longi);
+            }
+        }
+        for (const edgeNode& edge : origin.adj) {
+            adjacent[edge.vertex] = false;
+        }
+    }
+
+    return dist;
+}
@@ -12,8 +12,24 @@
 #include <limits>
 #include <stack>
 #include <cmath>
+#include <atomic>
+#include <functional>
 
 #define EARTH_RADIUS (double)6371000.0
+// até este número de vértices as pesquisas locais usam a matriz de distâncias completa
+#define DENSE_MATRIX_VERTICES 2000
+// limite de Held-Karp: iterações sem melhoria antes de reduzir o passo a metade, passo mínimo (convergência) e
+// candidatos por vértice no 2-opt do ciclo de referência
+#define HELD_KARP_PERIOD 30
+#define HELD_KARP_MIN_STEP 1e-4
+#define HELD_KARP_NEIGHBOURS 10
+// candidatos por vértice no 2-opt de cada cluster e tamanho máximo de um cluster, em múltiplos do tamanho pedido
+#define CLUSTER_NEIGHBOURS 30
+#define CLUSTER_MAX_FACTOR 2
+// número médio de vértices por célula da grelha usada nas listas de candidatos (Graph::nearestCandidates)
+#define CANDIDATE_GRID_DENSITY 2
+// o branch-and-bound só calcula a árvore geradora mínima dos vértices por visitar quando faltam pelo menos estes
+#define BRANCH_AND_BOUND_TREE_VERTICES 5
 
 struct Edge{
     int origin;
@@ -26,6 +42,58 @@ struct edgeNode{
     double distance;
 };
 
+// estado partilhado pelo branch-and-bound durante a pesquisa exata
+struct SearchBound{
+    double lower_bound;          // limite inferior global (Held-Karp), 0 se desconhecido
+    double gap_threshold;        // para assim que (UB - LB) / LB <= gap_threshold
+    std::vector<double> min_out; // aresta de saída mais barata de cada vértice
+    double remaining_min_out;    // soma de min_out dos vértices ainda por visitar
+    // matriz n*n com o peso de cada aresta (infinito sem aresta, Graph::edgeWeightMatrix); se existir, a pesquisa também
+    // corta com a árvore geradora mínima dos vértices por visitar
+    const std::vector<double>* weights = nullptr;
+    std::vector<int> best_path;
+    long long expanded_nodes;
+    bool stop;
+
+    // usados quando a pesquisa corre em paralelo com outros solvers (portefólio)
+    const std::atomic<bool>* cancel = nullptr;           // pedido externo para parar
+    const std::atomic<double>* shared_cost = nullptr;    // custo do melhor ciclo encontrado por qualquer solver
+    std::function<void(double, const std::vector<int>&)> on_improvement; // chamado a cada novo melhor ciclo
+
+    // usados para suspender a pesquisa (checkpoints): quando suspend fica ativo a pesquisa pára e deixa em frontier os
+    // prefixos ainda por explorar, pela ordem em que a pesquisa os visitaria
+    const std::atomic<bool>* suspend = nullptr;
+    bool suspended = false;
+    std::vector<std::vector<int>> frontier;
+};
+
+// resultado do pré-processamento feito antes de uma pesquisa exata
+struct PreprocessReport{
+    bool feasible;
+    std::string reason;                           // porque é que a instância não tem ciclo hamiltoniano
+    int components;
+    std::vector<int> articulation_points;
+    std::vector<int> low_degree_vertices;         // vértices com grau < 2
+    std::vector<std::pair<int, int>> forced_edges; // arestas presentes em qualquer ciclo hamiltoniano
+    int removed_edges;                            // arestas dominadas removidas
+    double seconds;
+};
+
+// perfil rápido de um grafo (Graph::profile), usado para escolher o pipeline de resolução
+struct GraphProfile{
+    int vertices;
+    long long edges;             // pares de vértices ligados por uma aresta
+    double density;              // edges / pares de vértices possíveis
+    int min_degree;
+    bool complete;               // todos os pares têm aresta
+    bool coordinates;            // algum vértice tem coordenadas
+    long long triangles;         // triplos (u, v, w) amostrados com os três custos conhecidos
+    long long violations;        // triplos com custo(u, w) > custo(u, v) + custo(v, w)
+    double violation_rate;       // violations / triangles (0 se nenhum triplo foi amostrado)
+    int threads;
+    double seconds;
+};
+
 struct vertexNode{
     int vertex;
     double lat;
@@ -35,6 +103,8 @@ struct vertexNode{
     std::vector<edgeNode> adj;
 };
 
+class MetricClosure;
+
 class Graph {
     public:
         Graph(bool dir);
@@ -46,22 +116,28 @@ class Graph {
         bool isDirected() const;
 
         // vertex exists
-        bool vertexExists(int vertex);
+        bool vertexExists(int vertex) const;
 
         //get lat
-        double getLat(int vertex);
+        double getLat(int vertex) const;
 
         //get longi
-        double getLongi(int vertex);
+        double getLongi(int vertex) const;
 
         //get label
-        std::string getLabel(int vertex);
+        std::string getLabel(int vertex) const;
+
+        //get adjacency list (read-only, safe to share between threads)
+        const std::vector<edgeNode>& getAdjacent(int vertex) const;
+
+        //get vertices (without copying them)
+        const std::unordered_map<int, vertexNode>& getVertices() const;
 
-        //get vertices
-        std::unordered_map<int, vertexNode> getVertices();
+        // bytes ocupados pelo grafo (mapa de vértices, labels e listas de adjacências)
+        size_t memoryFootprint() const;
 
         //get distance
-        double getDistance(int v1, int v2);
+        double getDistance(int v1, int v2) const;
 
         void setVertexInfo(int vertex, double lat, double longi);
 
@@ -70,23 +146,79 @@ class Graph {
         // add edge from v1 to v2, and from v2 to v1 if directed
         void addEdge(int v1, int v2, double distance);
 
-        void printGraph();
+        bool removeEdge(int v1, int v2);
+
+        void printGraph() const;
 
         void tsp_backtrack(std::vector<int>& path, std::vector<bool>& visited, double& min_cost, double cost_so_far);
 
-        std::vector<std::pair<int, int>> primMST(std::vector<int>& parent);
+        std::vector<std::pair<int, int>> primMST(std::vector<int>& parent) const;
+
+        void dfs(int current, const std::vector<int>& parent, std::vector<bool>& visited, std::stack<int>& cityStack, std::vector<int>& path) const;
+
+        double calculateTotalDistance(const std::vector<int>& path) const;
+
+        double triangularApproximation() const;
+
+        double triangularApproximation(const std::vector<int>& parent) const;
+
+        std::vector<int> mstPreorder(const std::vector<int>& parent) const;
+
+        bool check_if_nodes_are_connected(int v1, int v2) const;
+
+        static double haversine(double lat1, double lon1, double lat2, double lon2);
+
+        std::vector<int> nearestNeighbour(int start_vertex) const;
+
+        std::vector<int> spaceFillingCurveTour(int num_threads) const;
+
+        // custo de ir de v1 a v2, com a mesma regra de calculateTotalDistance
+        double travelCost(int v1, int v2) const;
+
+        // matriz n*n (row-major) com travelCost entre todos os pares
+        std::vector<double> buildDistanceMatrix() const;
+
+        double oneTree(const std::vector<double>& dist, const std::vector<double>& pi, std::vector<int>& degree) const;
+
+        double heldKarpBound(int max_iterations, double upper_bound, bool* converged = nullptr) const;
+
+        std::vector<double> cheapestOutgoingEdges() const;
+
+        std::vector<double> edgeWeightMatrix() const;
+
+        void tsp_branch_and_bound(std::vector<int>& path, std::vector<bool>& visited, double& min_cost, double cost_so_far, SearchBound& bound) const;
+
+        PreprocessReport preprocess();
+
+        GraphProfile profile(int samples, int num_threads) const;
+
+        bool hasCoordinates() const;
+
+        std::vector<std::vector<int>> partitionVertices(int num_clusters, int num_threads) const;
+
+        void repairSeams(std::vector<int>& tour, const std::vector<int>& seams, int window) const;
+
+        std::vector<int> clusteredTour(int cluster_size, int num_threads) const;
+
+        std::vector<std::vector<int>> nearestCandidates(int k) const;
+
+        std::string twoOpt(std::vector<int>& path, int neighbours, double target_cost, bool use_matrix = true) const;
+
+        static double twoOptOnMatrix(std::vector<int>& path, const std::vector<double>& dist, int neighbours, double target_cost);
+
+        static std::vector<int> nearestNeighbourOnMatrix(const std::vector<double>& dist, int n, int start_vertex);
 
-        void dfs(int current, const std::vector<int>& parent, std::vector<bool>& visited, std::stack<int>& cityStack, std::vector<int>& path);
+        std::vector<int> nearestNeighbourClosure(int start_vertex, MetricClosure& closure) const;
 
-        double calculateTotalDistance(const std::vector<int>& path);
+        double closureTourCost(const std::vector<int>& path, MetricClosure& closure) const;
 
-        double triangularApproximation();
+        std::vector<int> expandTour(const std::vector<int>& path, MetricClosure& closure) const;
 
-        bool check_if_nodes_are_connected(int v1, int v2);
+        std::vector<int> greedyEdgeTour(int neighbours, int num_threads) const;
 
-        double haversine(double lat1, double lon1, double lat2, double lon2);
+        std::vector<int> localityOrder() const;
 
-        std::vector<int> nearestNeighbour(int start_vertex);
+        void renumber(const std::vector<int>& order);
 
 
     protected:
@@ -0,0 +1,289 @@
+#include "graph_registry.h"
+#include "mem_stats.h"
+
+#include <chrono>
+
+/// @brief Devolve o registo do processo, criado na primeira chamada.
+GraphRegistry& GraphRegistry::instance() {
+    static GraphRegistry registry;
+    return registry;
+}
+
+GraphRegistry::GraphRegistry() {}
+
+/// @brief Para a thread de carregamento, esperando que termine o dataset que estiver a ler.
+GraphRegistry::~GraphRegistry() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        queue.clear();
+    }
+    changed.notify_all();
+    if (loader.joinable()) loader.join();
+}
+
+/// @brief Regista um dataset guardado num único ficheiro (arestas, com labels opcionais).
+/// @param name Nome do dataset.
+/// @param edges_file Filepath do ficheiro.
+void GraphRegistry::add(const std::string& name, const std::string& edges_file) {
+    add(name, "", edges_file);
+}
+
+/// @brief Regista um dataset guardado num ficheiro de nós e num ficheiro de arestas.
+/// @param name Nome do dataset.
+/// @param nodes_file Filepath do ficheiro de nós (vazio se o dataset só tiver um ficheiro).
+/// @param edges_file Filepath do ficheiro de arestas.
+void GraphRegistry::add(const std::string& name, const std::string& nodes_file, const std::string& edges_file) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (entries.count(name)) return;
+    Entry& entry = entries[name];
+    entry.info = {name, nodes_file, edges_file, LoadStatus::NotLoaded, "", 0, 0.0};
+}
+
+bool GraphRegistry::contains(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.count(name) > 0;
+}
+
+/// @brief Põe o dataset na fila da thread de carregamento, que é criada no primeiro pedido.
+/// Não faz nada se o dataset não existir, já tiver sido pedido, ou tiver falhado, sido ignorado ou descartado por
+/// causa do limite de memória (nesses casos só é lido quando for pedido com get).
+/// @param name Nome do dataset.
+void GraphRegistry::preload(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(name);
+    if (it == entries.end() || stopping) return;
+    if (it->second.info.status != LoadStatus::NotLoaded || !it->second.info.note.empty()) return;
+
+    it->second.info.status = LoadStatus::Queued;
+    queue.push_back(name);
+    if (!loader.joinable()) loader = std::thread(&GraphRegistry::loaderLoop, this);
+    changed.notify_all();
+}
+
+/// @brief Devolve o grafo de um dataset.
+/// Se estiver a ser carregado em segundo plano espera por ele; caso contrário é carregado nesta thread.
+/// Para respeitar o limite de memória podem ser descartados os datasets usados há mais tempo (quem ainda tiver o
+/// grafo continua a poder usá-lo).
+/// @param name Nome do dataset.
+/// @return Grafo imutável, ou nullptr se o dataset não existir ou não puder ser lido.
+std::shared_ptr<const Graph> GraphRegistry::get(const std::string& name) {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = entries.find(name);
+    if (it == entries.end()) return nullptr;
+    Entry& entry = it->second;
+    entry.last_used = ++clock;
+
+    changed.wait(lock, [&]() { return entry.info.status != LoadStatus::Loading; });
+    if (entry.info.status == LoadStatus::Queued) {
+        // take it out of the queue and load it right away
+        queue.erase(std::remove(queue.begin(), queue.end(), name), queue.end());
+    }
+    if (entry.info.status != LoadStatus::Loaded) load(name, lock, false);
+
+    if (entry.info.status != LoadStatus::Loaded) return nullptr;
+    return entry.graph;
+}
+
+void GraphRegistry::setMemoryCap(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    memory_cap = bytes;
+}
+
+size_t GraphRegistry::getMemoryCap() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return memory_cap;
+}
+
+/// @brief Devolve o estado de todos os datasets registados, por ordem de nome.
+std::vector<DatasetInfo> GraphRegistry::datasets() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<DatasetInfo> result;
+    for (auto& entry : entries) result.push_back(entry.second.info);
+    return result;
+}
+
+/// @brief Imprime o estado de carregamento de cada dataset e a memória ocupada.
+/// @param out Stream de saída.
+void GraphRegistry::printStatus(std::ostream& out) {
+    static const char* names[] = {"not loaded", "queued", "loading", "loaded", "failed"};
+
+    size_t total = 0;
+    for (const DatasetInfo& info : datasets()) {
+        out << info.name << ": " << names[(int)info.status];
+        if (info.status == LoadStatus::Loaded) {
+            out << " (" << info.bytes << " bytes, " << info.seconds << " seconds)";
+            total += info.bytes;
+        }
+        if (!info.note.empty()) out << " - " << info.note;
+        out << std::endl;
+    }
+    out << "Registry Memory: " << total << " of " << getMemoryCap() << " bytes" << std::endl;
+}
+
+/// @brief Corpo da thread de carregamento: lê os datasets da fila, um de cada vez.
+/// A thread é excluída dos contadores de memória globais, para que as suas leituras não sejam atribuídas à fase que a
+/// thread principal estiver a medir; cada leitura conta apenas para a sua própria fase de carregamento.
+void GraphRegistry::loaderLoop() {
+    MemStats::excludeThread();
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [&]() { return stopping || !queue.empty(); });
+        if (stopping) return;
+
+        std::string name = queue.front();
+        queue.pop_front();
+        if (entries[name].info.status == LoadStatus::Queued) load(name, lock, true);
+    }
+}
+
+/// @brief Lê um dataset, com o mutex libertado durante a leitura.
+/// A leitura é medida numa fase de memória "load [<nome>]", registada na thread que a faz.
+/// Em segundo plano um dataset que não caiba no limite de memória é descartado; num pedido explícito são descartados
+/// os datasets usados há mais tempo.
+/// @param name Nome do dataset.
+/// @param lock Lock do mutex do registo, que tem de estar adquirido.
+/// @param background True se o pedido veio de preload.
+void GraphRegistry::load(const std::string& name, std::unique_lock<std::mutex>& lock, bool background) {
+    Entry& entry = entries[name];
+    entry.info.status = LoadStatus::Loading;
+    entry.info.note.clear();
+    DatasetInfo info = entry.info;
+
+    lock.unlock();
+    MemPhase phase("load [" + name + "]");
+    auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<Graph> graph = std::make_shared<Graph>(true);
+    bool readable;
+    if (info.nodes_file.empty()) {
+        CsvReader edges_reader(info.edges_file);
+        readable = !edges_reader.is_error();
+        readOneFile(edges_reader, *graph);
+    } else {
+        CsvReader nodes_reader(info.nodes_file);
+        CsvReader edges_reader(info.edges_file);
+        readable = !nodes_reader.is_error();
+        readTwoFiles(nodes_reader, edges_reader, *graph);
+    }
+    size_t bytes = graph->memoryFootprint();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    phase.end();
+    lock.lock();
+
+    if (!readable || graph->getNumVertices() == 0) {
+        entry.info.status = LoadStatus::Failed;
+        entry.info.note = readable ? "no vertices read" : "cannot open file";
+    } else if (background && loadedBytes() + bytes > memory_cap) {
+        entry.info.status = LoadStatus::NotLoaded;
+        entry.info.note = "skipped, would exceed the memory cap";
+    } else {
+        entry.graph = graph;
+        entry.info.status = LoadStatus::Loaded;
+        entry.info.bytes = bytes;
+        entry.info.seconds = seconds;
+        evictFor(name);
+    }
+    changed.notify_all();
+}
+
+/// @brief Memória ocupada pelos grafos carregados.
+size_t GraphRegistry::loadedBytes() const {
+    size_t total = 0;
+    for (auto& entry : entries) {
+        if (entry.second.info.status == LoadStatus::Loaded) total += entry.second.info.bytes;
+    }
+    return total;
+}
+
+/// @brief Descarta os datasets usados há mais tempo até a memória caber no limite, mantendo o indicado.
+/// @param name Dataset que não pode ser descartado.
+void GraphRegistry::evictFor(const std::string& name) {
+    while (loadedBytes() > memory_cap) {
+        Entry* oldest = nullptr;
+        for (auto& entry : entries) {
+            if (entry.first == name || entry.second.info.status != LoadStatus::Loaded) continue;
+            if (oldest == nullptr || entry.second.last_used < oldest->last_used) oldest = &entry.second;
+        }
+        if (oldest == nullptr) return;
+        oldest->graph.reset();
+        oldest->info.status = LoadStatus::NotLoaded;
+        oldest->info.bytes = 0;
+        oldest->info.note = "evicted to stay under the memory cap";
+    }
+}
+
+/// @brief Lê um grafo guardado num ficheiro de nós e num ficheiro de arestas.
+/// @param nodes_reader Leitor do ficheiro de nós (id, latitude, longitude).
+/// @param edges_reader Leitor do ficheiro de arestas (origem, destino, distância).
+/// @param graph Grafo onde são adicionados os vértices e as arestas.
+void GraphRegistry::readTwoFiles(CsvReader& nodes_reader, CsvReader& edges_reader, Graph& graph) {
+    std::vector<std::string> line;
+
+    while(!nodes_reader.is_eof() && !nodes_reader.is_error()){
+        line = nodes_reader.read_line();
+        if(line.size() == 3){
+            graph.addVertex(std::stoi(line[0]), std::stod(line[1]), std::stod(line[2]), "");
+        }
+    }
+
+    while(!edges_reader.is_eof() && !edges_reader.is_error()){
+        line = edges_reader.read_line();
+        if(line.size() == 3){
+            graph.addEdge(std::stoi(line[0]), std::stoi(line[1]), std::stod(line[2]));
+        }
+    }
+}
+
+/// @brief Lê um grafo guardado num único ficheiro de arestas (origem, destino, distância e, opcionalmente, labels).
+/// @param edges_reader Leitor do ficheiro.
+/// @param graph Grafo onde são adicionados os vértices e as arestas.
+void GraphRegistry::readOneFile(CsvReader& edges_reader, Graph& graph) {
+    std::vector<std::string> line;
+
+    while(!edges_reader.is_eof() && !edges_reader.is_error()){
+        line = edges_reader.read_line();
+        bool can_add_edge = false;
+
+        if(line.size() == 5) {
+            //se a origem não existe, adiciono
+            if (!graph.vertexExists(std::stoi(line[0]))) {
+                graph.addVertex(std::stoi(line[0]), 0, 0, line[3]);
+                //se o destino não existe, adiciono
+                if (!graph.vertexExists(std::stoi(line[1]))) {
+                    graph.addVertex(std::stoi(line[1]), 0, 0, line[4]);
+                    can_add_edge = true;
+                } else can_add_edge = true;
+                //Se o destino não existe mas a origem existe, adiciono o destino
+            } else if (!graph.vertexExists(std::stoi(line[1]))) {
+                graph.addVertex(std::stoi(line[1]), 0, 0, line[4]);
+                can_add_edge = true;
+            } else can_add_edge = true;
+            //Se os dois vertices existem, adiciono a aresta
+            if (can_add_edge) {
+                graph.addEdge(std::stoi(line[0]), std::stoi(line[1]), std::stod(line[2]));
+            }
+        }
+        else if(line.size() == 3){
+            //se a origem nao existe, adiciona a origem
+            if(!graph.vertexExists(std::stoi(line[0]))){
+                graph.addVertex(std::stoi(line[0]), 0, 0, "");
+                //se o destino nao existe, adiciona o destino
+                if(!graph.vertexExists(std::stoi(line[1]))){
+                    graph.addVertex(std::stoi(line[1]), 0, 0, "");
+                    can_add_edge = true;
+                }
+                else can_add_edge = true;
+            }
+            //se o destino nao existe, mas a origem existe, adiciona o destino
+            else if(!graph.vertexExists(std::stoi(line[1]))){
+                graph.addVertex(std::stoi(line[1]), 0, 0, "");
+                can_add_edge = true;
+            }
+            else can_add_edge = true;
+
+            if(can_add_edge){
+                graph.addEdge(std::stoi(line[0]), std::stoi(line[1]), std::stod(line[2]));
+            }
+        }
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef PROJETO2DA_GRAPH_REGISTRY_H
+#define PROJETO2DA_GRAPH_REGISTRY_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <iostream>
+
+#include "graph.h"
+#include "csv_reader.h"
+
+// memória máxima ocupada pelos grafos carregados no registo (bytes)
+#define GRAPH_REGISTRY_MEMORY ((size_t)1024 * 1024 * 1024)
+
+enum class LoadStatus { NotLoaded, Queued, Loading, Loaded, Failed };
+
+// dataset conhecido pelo registo: um ficheiro com arestas (e labels) ou um ficheiro de nós e outro de arestas
+struct DatasetInfo {
+    std::string name;
+    std::string nodes_file;   // vazio se o dataset só tiver um ficheiro
+    std::string edges_file;
+    LoadStatus status;
+    std::string note;         // erro, ou motivo de não estar carregado
+    size_t bytes;
+    double seconds;
+};
+
+// registo de grafos partilhado por todo o processo: os datasets são lidos uma única vez, numa thread em segundo plano
+// (preload) ou quando são pedidos (get), e ficam disponíveis como grafos imutáveis partilhados, até ao limite de memória
+class GraphRegistry {
+public:
+    static GraphRegistry& instance();
+
+    ~GraphRegistry();
+
+    GraphRegistry(const GraphRegistry&) = delete;
+    GraphRegistry& operator=(const GraphRegistry&) = delete;
+
+    // regista um dataset; não faz nada se o nome já existir
+    void add(const std::string& name, const std::string& edges_file);
+    void add(const std::string& name, const std::string& nodes_file, const std::string& edges_file);
+
+    bool contains(const std::string& name);
+
+    // pede que o dataset seja carregado em segundo plano
+    void preload(const std::string& name);
+
+    // grafo do dataset, esperando pelo carregamento (ou carregando-o nesta thread); nullptr se falhar
+    std::shared_ptr<const Graph> get(const std::string& name);
+
+    void setMemoryCap(size_t bytes);
+    size_t getMemoryCap();
+
+    std::vector<DatasetInfo> datasets();
+
+    void printStatus(std::ostream& out);
+
+    // leitura dos formatos de ficheiro suportados
+    static void readTwoFiles(CsvReader& nodes_reader, CsvReader& edges_reader, Graph& graph);
+    static void readOneFile(CsvReader& edges_reader, Graph& graph);
+
+private:
+    GraphRegistry();
+
+    struct Entry {
+        DatasetInfo info;
+        std::shared_ptr<const Graph> graph;
+        unsigned long long last_used = 0;
+    };
+
+    void loaderLoop();
+
+    void load(const std::string& name, std::unique_lock<std::mutex>& lock, bool background);
+
+    size_t loadedBytes() const;
+
+    void evictFor(const std::string& name);
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::map<std::string, Entry> entries;
+    std::deque<std::string> queue;
+    std::thread loader;
+    bool stopping = false;
+    size_t memory_cap = GRAPH_REGISTRY_MEMORY;
+    unsigned long long clock = 0;
+};
+
+#endif //PROJETO2DA_GRAPH_REGISTRY_H
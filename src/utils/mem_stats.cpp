@@ -0,0 +1,308 @@
+#include "mem_stats.h"
+
+#include <cstdlib>
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <malloc.h>
+
+namespace {
+    std::atomic<bool> enabled(false);
+    std::atomic<AllocationHook> hook(nullptr);
+
+    std::atomic<size_t> allocations(0);
+    std::atomic<size_t> frees(0);
+    std::atomic<size_t> bytes_allocated(0);
+    std::atomic<size_t> bytes_freed(0);
+    // signed: memory allocated before enabling may be freed afterwards
+    std::atomic<long long> live_bytes(0);
+    std::atomic<long long> peak_live_bytes(0);
+
+    std::vector<PhaseStats> recorded;
+    std::mutex recorded_mutex;
+
+    // set while this thread is inside MemStats' own bookkeeping, whose allocations are not counted; being per thread,
+    // the other threads keep being counted meanwhile
+    thread_local bool suspended = false;
+
+    // set on threads excluded with MemStats::excludeThread: their allocations go to the counters below, which only
+    // that thread touches, so they never show up in a phase opened by another thread
+    thread_local bool excluded = false;
+    thread_local AllocationCounters own = {0, 0, 0, 0, 0};
+    thread_local long long own_live_bytes = 0;
+
+    bool counting() {
+        return enabled.load(std::memory_order_relaxed) && !suspended;
+    }
+
+    // suspends the counting on this thread while the object exists (nested uses keep the outer state)
+    class SuspendCounting {
+    public:
+        SuspendCounting() : previous(suspended) { suspended = true; }
+        ~SuspendCounting() { suspended = previous; }
+    private:
+        bool previous;
+    };
+
+    void countAllocation(void* ptr) {
+        size_t bytes = malloc_usable_size(ptr);
+        if (excluded) {
+            own.allocations++;
+            own.bytes_allocated += bytes;
+            own_live_bytes += bytes;
+            own.peak_live_bytes = std::max(own.peak_live_bytes, own_live_bytes);
+            return;
+        }
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+        long long live = live_bytes.fetch_add(bytes, std::memory_order_relaxed) + (long long)bytes;
+        long long peak = peak_live_bytes.load(std::memory_order_relaxed);
+        while (live > peak && !peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+        AllocationHook h = hook.load(std::memory_order_relaxed);
+        if (h) h(bytes, true);
+    }
+
+    void countFree(void* ptr) {
+        size_t bytes = malloc_usable_size(ptr);
+        if (excluded) {
+            own.frees++;
+            own.bytes_freed += bytes;
+            own_live_bytes -= bytes;
+            return;
+        }
+        frees.fetch_add(1, std::memory_order_relaxed);
+        bytes_freed.fetch_add(bytes, std::memory_order_relaxed);
+        live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        AllocationHook h = hook.load(std::memory_order_relaxed);
+        if (h) h(bytes, false);
+    }
+
+    size_t readStatus(const std::string& key) {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.compare(0, key.size(), key) == 0) {
+                return std::strtoull(line.c_str() + key.size(), nullptr, 10) * 1024;
+            }
+        }
+        return 0;
+    }
+}
+
+// global allocator: plain malloc/free, counted only while MemStats is enabled (and not by its own bookkeeping)
+void* operator new(size_t size) {
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (!ptr) throw std::bad_alloc();
+    if (counting()) countAllocation(ptr);
+    return ptr;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr && counting()) countAllocation(ptr);
+    return ptr;
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+// over-aligned types (alignas above __STDCPP_DEFAULT_NEW_ALIGNMENT__) come through these; glibc's free and
+// malloc_usable_size accept memory from posix_memalign, so they share the counting and the deletes below
+void* operator new(size_t size, std::align_val_t alignment) {
+    void* ptr = nullptr;
+    size_t align = std::max((size_t)alignment, sizeof(void*));
+    if (posix_memalign(&ptr, align, size == 0 ? 1 : size) != 0) throw std::bad_alloc();
+    if (counting()) countAllocation(ptr);
+    return ptr;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    void* ptr = nullptr;
+    size_t align = std::max((size_t)alignment, sizeof(void*));
+    if (posix_memalign(&ptr, align, size == 0 ? 1 : size) != 0) return nullptr;
+    if (counting()) countAllocation(ptr);
+    return ptr;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t& tag) noexcept {
+    return operator new(size, alignment, tag);
+}
+
+void operator delete(void* ptr) noexcept {
+    if (!ptr) return;
+    if (counting()) countFree(ptr);
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    operator delete(ptr);
+}
+
+/// @brief Ativa ou desativa a contagem de alocações.
+void MemStats::enable(bool on) {
+    enabled = on;
+}
+
+bool MemStats::isEnabled() {
+    return enabled;
+}
+
+/// @brief Define uma função chamada em cada alocação e libertação contadas (nullptr para remover).
+void MemStats::setHook(AllocationHook h) {
+    hook = h;
+}
+
+/// @brief Exclui a thread atual dos contadores globais: as suas alocações deixam de contar para as fases das outras
+/// threads e passam a contar apenas para as fases abertas nesta thread (por exemplo, a thread de carregamento do
+/// GraphRegistry, que lê grafos enquanto a thread principal mede uma fase).
+void MemStats::excludeThread() {
+    excluded = true;
+}
+
+/// @brief Devolve os contadores acumulados desde o início do programa (os da própria thread, se estiver excluída).
+AllocationCounters MemStats::counters() {
+    if (excluded) return own;
+    return AllocationCounters{allocations, frees, bytes_allocated, bytes_freed, peak_live_bytes};
+}
+
+/// @brief Reinicia o pico de memória viva para o valor atual, para medir o pico de uma fase.
+void MemStats::resetPeak() {
+    if (excluded) own.peak_live_bytes = own_live_bytes;
+    else peak_live_bytes = live_bytes.load();
+}
+
+/// @brief Repõe um pico guardado antes de resetPeak, se for maior que o atual; assim uma fase interior não apaga o
+/// pico da fase que a contém.
+/// @param peak Pico de memória viva guardado.
+void MemStats::restorePeak(long long peak) {
+    if (excluded) {
+        own.peak_live_bytes = std::max(own.peak_live_bytes, peak);
+        return;
+    }
+    long long current = peak_live_bytes.load();
+    while (peak > current && !peak_live_bytes.compare_exchange_weak(current, peak)) {}
+}
+
+size_t MemStats::currentRss() {
+    return readStatus("VmRSS:");
+}
+
+size_t MemStats::peakRss() {
+    return readStatus("VmHWM:");
+}
+
+/// @brief Devolve uma cópia das fases registadas (outras threads podem estar a registar fases).
+std::vector<PhaseStats> MemStats::phases() {
+    std::lock_guard<std::mutex> lock(recorded_mutex);
+    return recorded;
+}
+
+void MemStats::clearPhases() {
+    SuspendCounting suspend;
+    std::lock_guard<std::mutex> lock(recorded_mutex);
+    recorded.clear();
+}
+
+/// @brief Guarda as estatísticas de uma fase terminada; a memória da lista não conta para as fases.
+void MemStats::recordPhase(const PhaseStats& phase) {
+    SuspendCounting suspend;
+    std::lock_guard<std::mutex> lock(recorded_mutex);
+    recorded.push_back(phase);
+}
+
+/// @brief Imprime as fases registadas e o RSS do processo, sem contar as alocações do próprio relatório.
+/// @param out Stream onde é escrito o relatório.
+void MemStats::printReport(std::ostream& out) {
+    SuspendCounting suspend;
+    std::lock_guard<std::mutex> lock(recorded_mutex);
+    for (const PhaseStats& phase : recorded) {
+        out << "Memory [" << phase.name << "]: " << phase.allocations << " allocations, "
+            << phase.frees << " frees, " << phase.bytes_allocated << " bytes allocated, "
+            << phase.net_bytes << " bytes retained, peak +" << phase.peak_live_bytes << " bytes, "
+            << phase.seconds << " seconds" << std::endl;
+    }
+    out << "Memory [process]: RSS " << currentRss() / 1024 << " KiB, peak RSS " << peakRss() / 1024 << " KiB" << std::endl;
+}
+
+/// @brief Começa uma fase; as alocações feitas até o objeto ser destruído são atribuídas a esta fase.
+/// @param name Nome da fase.
+MemPhase::MemPhase(const std::string& name) : name(name), active(MemStats::isEnabled()) {
+    if (!active) return;
+    // an enclosing phase measures its peak on the same counter, so it is put back in end()
+    outer_peak = MemStats::counters().peak_live_bytes;
+    MemStats::resetPeak();
+    start = MemStats::counters();
+    start_time = std::chrono::steady_clock::now();
+}
+
+/// @brief Termina a fase, se ainda não tiver sido terminada com end().
+MemPhase::~MemPhase() {
+    end();
+}
+
+/// @brief Termina a fase e guarda as suas estatísticas.
+void MemPhase::end() {
+    if (!active) return;
+    active = false;
+    AllocationCounters end = MemStats::counters();
+    PhaseStats phase;
+    phase.name = name;
+    phase.allocations = end.allocations - start.allocations;
+    phase.frees = end.frees - start.frees;
+    phase.bytes_allocated = end.bytes_allocated - start.bytes_allocated;
+    phase.net_bytes = (long long)(end.bytes_allocated - start.bytes_allocated) - (long long)(end.bytes_freed - start.bytes_freed);
+    phase.peak_live_bytes = std::max(0LL, end.peak_live_bytes - start.peak_live_bytes);
+    phase.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    MemStats::recordPhase(phase);
+    MemStats::restorePeak(outer_peak);
+}
@@ -0,0 +1,79 @@
+#ifndef PROJETO2DA_MEM_STATS_H
+#define PROJETO2DA_MEM_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// contadores do alocador global (operator new/delete substituídos em mem_stats.cpp)
+struct AllocationCounters{
+    size_t allocations;
+    size_t frees;
+    size_t bytes_allocated;
+    size_t bytes_freed;
+    long long peak_live_bytes;
+};
+
+// alocações e tempo de uma fase (load, build, solve, evaluate, ...)
+struct PhaseStats{
+    std::string name;
+    size_t allocations;
+    size_t frees;
+    size_t bytes_allocated;
+    long long net_bytes;      // bytes ainda vivos no fim da fase
+    long long peak_live_bytes; // pico de memória viva durante a fase, acima do início
+    double seconds;
+};
+
+// função chamada em cada alocação (allocation = true) e libertação enquanto o registo está ativo;
+// não pode alocar memória
+typedef void (*AllocationHook)(size_t bytes, bool allocation);
+
+// instrumentação de memória, desativada por omissão
+class MemStats {
+public:
+    static void enable(bool on);
+    static bool isEnabled();
+
+    static void setHook(AllocationHook hook);
+
+    static void excludeThread();
+
+    static AllocationCounters counters();
+
+    // VmRSS / VmHWM de /proc/self/status, em bytes (0 se não estiver disponível)
+    static size_t currentRss();
+    static size_t peakRss();
+
+    static std::vector<PhaseStats> phases();
+    static void clearPhases();
+
+    static void printReport(std::ostream& out);
+
+    static void recordPhase(const PhaseStats& phase);
+    static void resetPeak();
+    static void restorePeak(long long peak);
+};
+
+// regista uma fase enquanto o objeto existe; não faz nada se MemStats não estiver ativo
+class MemPhase {
+public:
+    MemPhase(const std::string& name);
+    ~MemPhase();
+
+    // termina a fase antes do fim do bloco
+    void end();
+
+private:
+    std::string name;
+    bool active;
+    AllocationCounters start;
+    // pico da fase exterior quando esta começou
+    long long outer_peak;
+    std::chrono::steady_clock::time_point start_time;
+};
+
+#endif //PROJETO2DA_MEM_STATS_H
@@ -0,0 +1,161 @@
+#include "metric_closure.h"
+
+/// @brief Constrói uma closure métrica vazia sobre um grafo.
+/// @param graph Grafo (não é copiado, tem de existir enquanto a closure for usada).
+/// @param memory_cap Memória máxima, em bytes, ocupada pelas linhas em cache (pelo menos uma linha é sempre guardada).
+MetricClosure::MetricClosure(const Graph& graph, size_t memory_cap) :
+    graph(graph),
+    n(graph.getNumVertices()),
+    hits(0),
+    misses(0),
+    evictions(0) {
+    size_t row_bytes = std::max<size_t>(1, (size_t)n * (sizeof(double) + sizeof(int)));
+    max_rows = std::max<size_t>(1, memory_cap / row_bytes);
+}
+
+/// @brief Calcula as distâncias mínimas a partir de uma origem com o algoritmo de Dijkstra.
+/// Esta função tem complexidade O((V + E) log V).
+/// @param source Vértice de origem.
+/// @return Linha com distâncias e predecessores.
+std::shared_ptr<ClosureRow> MetricClosure::dijkstra(int source) const {
+    std::shared_ptr<ClosureRow> row = std::make_shared<ClosureRow>();
+    row->distance.assign(n, std::numeric_limits<double>::infinity());
+    row->predecessor.assign(n, -1);
+    row->distance[source] = 0.0;
+
+    std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int>>, std::greater<std::pair<double, int>>> pq;
+    pq.push(std::make_pair(0.0, source));
+
+    while (!pq.empty()) {
+        double d = pq.top().first;
+        int u = pq.top().second;
+        pq.pop();
+        if (d > row->distance[u]) continue;
+
+        for (const edgeNode& edge : graph.getAdjacent(u)) {
+            double nd = d + edge.distance;
+            if (nd < row->distance[edge.vertex]) {
+                row->distance[edge.vertex] = nd;
+                row->predecessor[edge.vertex] = u;
+                pq.push(std::make_pair(nd, edge.vertex));
+            }
+        }
+    }
+
+    return row;
+}
+
+/// @brief Guarda uma linha na cache, descartando as menos usadas recentemente se o limite for ultrapassado.
+void MetricClosure::insert(int source, const std::shared_ptr<ClosureRow>& row) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (cache.count(source)) return;
+
+    lru.push_front(source);
+    cache[source] = std::make_pair(row, lru.begin());
+
+    while (cache.size() > max_rows) {
+        cache.erase(lru.back());
+        lru.pop_back();
+        evictions++;
+    }
+}
+
+/// @brief Devolve a linha de uma origem, calculando-a se não estiver em cache.
+/// A linha devolvida continua válida mesmo que seja descartada da cache entretanto.
+/// Esta função tem complexidade O(1) se a linha estiver em cache e O((V + E) log V) caso contrário.
+/// @param source Vértice de origem.
+/// @return Linha com distâncias e predecessores.
+std::shared_ptr<const ClosureRow> MetricClosure::row(int source) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = cache.find(source);
+        if (it != cache.end()) {
+            lru.splice(lru.begin(), lru, it->second.second);
+            hits++;
+            return it->second.first;
+        }
+    }
+
+    misses++;
+    std::shared_ptr<ClosureRow> computed = dijkstra(source);
+    insert(source, computed);
+    return computed;
+}
+
+/// @brief Distância do caminho mais curto entre dois vértices.
+/// @param u Vértice de origem.
+/// @param v Vértice de destino.
+/// @return Distância mínima, ou infinito se v não for alcançável a partir de u.
+double MetricClosure::distance(int u, int v) {
+    if (u == v) return 0.0;
+    return row(u)->distance[v];
+}
+
+/// @brief Calcula em paralelo as linhas de várias origens.
+/// Só são calculadas tantas linhas quantas cabem na cache, para não descartar as que acabaram de ser calculadas.
+/// Esta função tem complexidade O(S * (V + E) log V / T), para S origens e T threads.
+/// @param sources Vértices de origem.
+/// @param num_threads Número de threads.
+void MetricClosure::prefetch(const std::vector<int>& sources, int num_threads) {
+    size_t count = std::min(sources.size(), max_rows);
+    std::atomic<size_t> next(0);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < std::max(1, num_threads); t++) {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < count; i = next++) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (cache.count(sources[i])) continue;
+                }
+                misses++;
+                insert(sources[i], dijkstra(sources[i]));
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+}
+
+/// @brief Reconstrói o caminho real entre dois vértices, a partir dos predecessores da linha de u.
+/// Esta função tem complexidade O(comprimento do caminho), mais o cálculo da linha se não estiver em cache.
+/// @param u Vértice de origem.
+/// @param v Vértice de destino.
+/// @return Vértices do caminho de u a v (vazio se v não for alcançável).
+std::vector<int> MetricClosure::expandPath(int u, int v) {
+    std::shared_ptr<const ClosureRow> r = row(u);
+    std::vector<int> path;
+    if (u != v && r->predecessor[v] == -1) return path;
+
+    for (int x = v; x != -1; x = r->predecessor[x]) {
+        path.push_back(x);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+size_t MetricClosure::getHits() const {
+    return hits;
+}
+
+size_t MetricClosure::getMisses() const {
+    return misses;
+}
+
+size_t MetricClosure::getEvictions() const {
+    return evictions;
+}
+
+size_t MetricClosure::memoryFootprint() {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t bytes = sizeof(MetricClosure);
+    for (auto& entry : cache) {
+        const ClosureRow& r = *entry.second.first;
+        bytes += sizeof(ClosureRow) + r.distance.capacity() * sizeof(double) + r.predecessor.capacity() * sizeof(int);
+    }
+    return bytes;
+}
+
+size_t MetricClosure::getCachedRows() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return cache.size();
+}
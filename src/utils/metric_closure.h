@@ -0,0 +1,63 @@
+#ifndef PROJETO2DA_METRIC_CLOSURE_H
+#define PROJETO2DA_METRIC_CLOSURE_H
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+
+#include "graph.h"
+
+// linha da closure: distâncias mínimas a partir de uma origem e predecessor de cada vértice no caminho
+struct ClosureRow{
+    std::vector<double> distance;
+    std::vector<int> predecessor;
+};
+
+// closure métrica de um grafo esparso: cada linha é calculada com Dijkstra quando é pedida pela primeira vez e fica
+// numa cache LRU com limite de memória, evitando materializar a matriz de todos os pares
+class MetricClosure {
+public:
+    MetricClosure(const Graph& graph, size_t memory_cap);
+
+    // distância do caminho mais curto de u a v (infinito se v não for alcançável)
+    double distance(int u, int v);
+
+    std::shared_ptr<const ClosureRow> row(int source);
+
+    // calcula as linhas das origens indicadas em paralelo (até ao limite de memória)
+    void prefetch(const std::vector<int>& sources, int num_threads);
+
+    // caminho real de u a v no grafo, incluindo os dois extremos
+    std::vector<int> expandPath(int u, int v);
+
+    size_t getHits() const;
+    size_t getMisses() const;
+    size_t getEvictions() const;
+    size_t getCachedRows();
+
+    // bytes ocupados pelas linhas em cache
+    size_t memoryFootprint();
+
+private:
+    std::shared_ptr<ClosureRow> dijkstra(int source) const;
+
+    void insert(int source, const std::shared_ptr<ClosureRow>& row);
+
+    const Graph& graph;
+    int n;
+    size_t max_rows;
+
+    std::mutex mutex;
+    std::list<int> lru; // origens, da mais recente para a menos recente
+    std::unordered_map<int, std::pair<std::shared_ptr<ClosureRow>, std::list<int>::iterator>> cache;
+
+    std::atomic<size_t> hits;
+    std::atomic<size_t> misses;
+    std::atomic<size_t> evictions;
+};
+
+#endif //PROJETO2DA_METRIC_CLOSURE_H
@@ -0,0 +1,57 @@
+#include "perf_counter.h"
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/// @brief Abre o contador de cache misses do processo atual (só em espaço de utilizador).
+PerfCounter::PerfCounter() : fd(-1) {
+#ifdef __linux__
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+}
+
+PerfCounter::~PerfCounter() {
+#ifdef __linux__
+    if (fd != -1) close(fd);
+#endif
+}
+
+bool PerfCounter::isAvailable() const {
+    return fd != -1;
+}
+
+/// @brief Põe o contador a zero e começa a contar.
+void PerfCounter::start() {
+#ifdef __linux__
+    if (fd == -1) return;
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+/// @brief Para o contador.
+/// @return Cache misses desde start(), ou -1 se o contador não estiver disponível.
+long long PerfCounter::stop() {
+#ifdef __linux__
+    if (fd == -1) return -1;
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    long long count = 0;
+    if (read(fd, &count, sizeof(count)) != sizeof(count)) return -1;
+    return count;
+#else
+    return -1;
+#endif
+}
@@ -0,0 +1,26 @@
+#ifndef PROJETO2DA_PERF_COUNTER_H
+#define PROJETO2DA_PERF_COUNTER_H
+
+#include <cstdint>
+
+// contador de cache misses do processador (perf_event_open, Linux); fica indisponível se o kernel não o permitir
+class PerfCounter {
+public:
+    PerfCounter();
+    ~PerfCounter();
+
+    PerfCounter(const PerfCounter&) = delete;
+    PerfCounter& operator=(const PerfCounter&) = delete;
+
+    bool isAvailable() const;
+
+    void start();
+
+    // número de cache misses desde start(), ou -1 se o contador não estiver disponível
+    long long stop();
+
+private:
+    int fd;
+};
+
+#endif //PROJETO2DA_PERF_COUNTER_H
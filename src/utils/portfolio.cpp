@@ -0,0 +1,134 @@
+#include "portfolio.h"
+
+#include <algorithm>
+
+/// @brief Constrói um portefólio vazio.
+/// @param deadline_seconds Prazo, em segundos, a partir do início de run().
+/// @param target_cost Os solvers param assim que houver um ciclo com custo <= target_cost (0 para desativar).
+/// @param lower_bound Limite inferior conhecido; um ciclo com este custo é ótimo (0 se desconhecido).
+Portfolio::Portfolio(double deadline_seconds, double target_cost, double lower_bound) :
+    deadline_seconds(deadline_seconds),
+    target_cost(target_cost),
+    lower_bound(lower_bound),
+    stop_flag(false),
+    best_cost(std::numeric_limits<double>::infinity()) {
+    result.cost = std::numeric_limits<double>::infinity();
+    result.found_at = 0.0;
+    result.seconds = 0.0;
+    result.optimal = false;
+}
+
+/// @brief Acrescenta um solver ao portefólio.
+/// @param name Nome usado no relatório.
+/// @param solver Função que corre o solver; deve consultar stopped() com frequência e propor ciclos com offer().
+void Portfolio::add(const std::string& name, Solver solver) {
+    solvers.emplace_back(name, std::move(solver));
+}
+
+/// @brief Corre todos os solvers em paralelo até um deles provar a otimalidade, ser atingido o custo alvo, passar o
+/// prazo ou terminarem todos.
+/// @return Melhor ciclo, o solver que o encontrou e quando, o motivo de paragem e o resumo de cada solver.
+PortfolioResult Portfolio::run() {
+    start = std::chrono::steady_clock::now();
+    running = solvers.size();
+    for (auto& solver : solvers) {
+        reports.push_back({solver.first, std::numeric_limits<double>::infinity(), 0.0, false});
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < solvers.size(); i++) {
+        threads.emplace_back([this, i]() {
+            solvers[i].second(*this, solvers[i].first);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            reports[i].seconds = elapsed();
+            reports[i].finished = reports[i].finished || !stop_flag.load();
+            running--;
+            changed.notify_all();
+        });
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(deadline_seconds));
+        bool done = changed.wait_until(lock, deadline, [&]() { return running == 0 || stop_flag.load(); });
+        if (!done) {
+            result.stop_reason = "deadline reached";
+            stop_flag = true;
+        } else if (running == 0 && result.stop_reason.empty()) {
+            result.stop_reason = "all solvers finished";
+        }
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    result.seconds = elapsed();
+    result.solvers = reports;
+    return result;
+}
+
+/// @brief Propõe um ciclo ao portefólio.
+/// Se for o melhor até agora fica como incumbente; se atingir o custo alvo ou o limite inferior, todos os solvers
+/// são parados.
+/// @param solver Nome do solver que encontrou o ciclo.
+/// @param cost Custo do ciclo.
+/// @param path Ciclo.
+/// @return True se o ciclo passou a ser o melhor.
+bool Portfolio::offer(const std::string& solver, double cost, const std::vector<int>& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (SolverReport& report : reports) {
+        if (report.name == solver) report.best_cost = std::min(report.best_cost, cost);
+    }
+    if (cost >= result.cost) return false;
+
+    result.cost = cost;
+    result.path = path;
+    result.winner = solver;
+    result.found_at = elapsed();
+    best_cost.store(cost);
+
+    if (lower_bound > 0.0 && cost <= lower_bound * (1.0 + 1e-9)) {
+        result.optimal = true;
+        stop("cost equals the lower bound");
+    } else if (target_cost > 0.0 && cost <= target_cost) {
+        stop("target cost reached");
+    }
+    return true;
+}
+
+/// @brief Indica que um solver exato esgotou a pesquisa sem ser parado, pelo que o melhor ciclo partilhado é ótimo.
+/// @param solver Nome do solver.
+void Portfolio::proveOptimal(const std::string& solver) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stop_flag.load()) return;
+    for (SolverReport& report : reports) {
+        if (report.name == solver) report.finished = true;
+    }
+    result.optimal = !result.path.empty();
+    stop(result.optimal ? "optimality proven by " + solver : "no Hamiltonian cycle (search exhausted by " + solver + ")");
+}
+
+/// @brief Pára todos os solvers; o mutex tem de estar adquirido.
+/// @param reason Motivo, mostrado no relatório (só o primeiro conta).
+void Portfolio::stop(const std::string& reason) {
+    if (!stop_flag.load()) result.stop_reason = reason;
+    stop_flag = true;
+    changed.notify_all();
+}
+
+bool Portfolio::stopped() const {
+    return stop_flag.load(std::memory_order_relaxed);
+}
+
+const std::atomic<bool>& Portfolio::stopFlag() const {
+    return stop_flag;
+}
+
+const std::atomic<double>& Portfolio::bestCost() const {
+    return best_cost;
+}
+
+/// @brief Segundos desde o início de run().
+double Portfolio::elapsed() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
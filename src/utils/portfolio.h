@@ -0,0 +1,80 @@
+#ifndef PROJETO2DA_PORTFOLIO_H
+#define PROJETO2DA_PORTFOLIO_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <limits>
+
+// resultado de um solver do portefólio
+struct SolverReport {
+    std::string name;
+    double best_cost;   // melhor ciclo que este solver encontrou (infinito se nenhum)
+    double seconds;     // quando terminou ou foi parado
+    bool finished;      // true se terminou antes de ser parado
+};
+
+// resultado de uma corrida do portefólio
+struct PortfolioResult {
+    std::string winner;       // solver que encontrou o melhor ciclo
+    double cost;
+    std::vector<int> path;
+    double found_at;          // segundos desde o início até o melhor ciclo ser encontrado
+    double seconds;           // duração total
+    std::string stop_reason;
+    bool optimal;             // true se algum solver provou a otimalidade do melhor ciclo
+    std::vector<SolverReport> solvers;
+};
+
+// corre vários solvers em simultâneo, cada um na sua thread, partilhando o melhor ciclo encontrado; pára todos quando
+// um deles prova a otimalidade, quando é atingido o custo alvo ou quando passa o prazo
+class Portfolio {
+public:
+    // o solver recebe o portefólio para ler o estado partilhado e propor ciclos
+    using Solver = std::function<void(Portfolio&, const std::string&)>;
+
+    Portfolio(double deadline_seconds, double target_cost, double lower_bound);
+
+    void add(const std::string& name, Solver solver);
+
+    PortfolioResult run();
+
+    // propõe um ciclo; devolve true se for o novo melhor
+    bool offer(const std::string& solver, double cost, const std::vector<int>& path);
+
+    // o solver esgotou a pesquisa: o melhor ciclo partilhado é ótimo
+    void proveOptimal(const std::string& solver);
+
+    bool stopped() const;
+
+    const std::atomic<bool>& stopFlag() const;
+    const std::atomic<double>& bestCost() const;
+
+private:
+    void stop(const std::string& reason);
+
+    double elapsed() const;
+
+    double deadline_seconds;
+    double target_cost;
+    double lower_bound;
+
+    std::vector<std::pair<std::string, Solver>> solvers;
+    std::vector<SolverReport> reports;
+
+    std::atomic<bool> stop_flag;
+    std::atomic<double> best_cost;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    PortfolioResult result;
+    int running = 0;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif //PROJETO2DA_PORTFOLIO_H
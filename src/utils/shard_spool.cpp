@@ -0,0 +1,290 @@
+#include "shard_spool.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char SHARD_SUFFIX[] = ".shard";
+const char RESULT_SUFFIX[] = ".result";
+
+bool endsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+std::string formatCost(double cost) {
+    if (cost == std::numeric_limits<double>::infinity()) return "inf";
+    std::ostringstream out;
+    out << std::setprecision(17) << cost;
+    return out.str();
+}
+
+double parseCost(const std::string& s) {
+    if (s == "inf") return std::numeric_limits<double>::infinity();
+    return std::stod(s);
+}
+
+}
+
+/// @brief Abre uma pasta de shards; não cria nem lê nada.
+/// @param directory Caminho da pasta, partilhada entre o coordenador e os workers.
+ShardSpool::ShardSpool(const std::string& directory) : directory(directory) {}
+
+const std::string& ShardSpool::getDirectory() const {
+    return directory.native();
+}
+
+/// @brief Escreve um ficheiro numa cópia temporária e renomeia-a, para que nunca seja lido incompleto.
+bool ShardSpool::writeFile(const std::string& file, const std::string& bytes) {
+    std::string temporary = file + ".tmp";
+    {
+        std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+        if (!stream.write(bytes.data(), (std::streamsize)bytes.size())) return false;
+    }
+    std::error_code error;
+    fs::rename(temporary, file, error);
+    return !error;
+}
+
+bool ShardSpool::readFile(const std::string& file, std::string& bytes) {
+    std::ifstream stream(file, std::ios::binary);
+    if (!stream.is_open()) return false;
+    bytes.assign((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    return true;
+}
+
+/// @brief Nomes dos ficheiros de uma subpasta, por ordem, sem as cópias temporárias.
+std::vector<std::string> ShardSpool::list(const std::string& folder) const {
+    std::vector<std::string> names;
+    std::error_code error;
+    for (fs::directory_iterator it(directory / folder, error), end; !error && it != end; it.increment(error)) {
+        std::string name = it->path().filename().string();
+        if (!endsWith(name, ".tmp")) names.push_back(name);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+/// @brief Prepara a pasta para um novo trabalho, apagando o de uma execução anterior, e escreve o ficheiro job.
+/// @param job Trabalho.
+/// @return False se a pasta não puder ser criada ou escrita.
+bool ShardSpool::create(const ShardJob& job) {
+    std::error_code error;
+    for (const char* entry : {"job", "incumbent", "stop", "pending", "running", "done"}) fs::remove_all(directory / entry, error);
+    for (const char* folder : {"pending", "running", "done", "logs"}) {
+        fs::create_directories(directory / folder, error);
+        if (error) return false;
+    }
+    seen.clear();
+    finished.clear();
+
+    std::ostringstream out;
+    out << std::setprecision(17);
+    out << "kind=" << job.kind << "\n";
+    out << "nodes_file=" << job.nodes_file << "\n";
+    out << "edges_file=" << job.edges_file << "\n";
+    out << "time_limit=" << job.time_limit << "\n";
+    out << "gap_threshold=" << job.gap_threshold << "\n";
+    out << "lower_bound=" << job.lower_bound << "\n";
+    return writeFile((directory / "job").string(), out.str());
+}
+
+/// @brief Lê o ficheiro job escrito pelo coordenador.
+/// @return False se não existir ou não indicar o problema e o grafo.
+bool ShardSpool::readJob(ShardJob& job) const {
+    std::string bytes;
+    if (!readFile((directory / "job").string(), bytes)) return false;
+    std::istringstream in(bytes);
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) continue;
+        std::string key = line.substr(0, equals), value = line.substr(equals + 1);
+        if (key == "kind") job.kind = value;
+        else if (key == "nodes_file") job.nodes_file = value;
+        else if (key == "edges_file") job.edges_file = value;
+        else if (key == "time_limit") job.time_limit = std::stod(value);
+        else if (key == "gap_threshold") job.gap_threshold = std::stod(value);
+        else if (key == "lower_bound") job.lower_bound = std::stod(value);
+    }
+    return !job.kind.empty() && !job.edges_file.empty();
+}
+
+std::string ShardSpool::pendingPath(const std::string& id) const {
+    return (directory / "pending" / (id + SHARD_SUFFIX)).string();
+}
+
+bool ShardSpool::addShard(const std::string& id, const std::string& payload) {
+    return writeFile(pendingPath(id), payload);
+}
+
+/// @brief Reserva o primeiro shard por reservar, renomeando-o para running/ com o nome do worker.
+/// Se outro worker o renomear primeiro, a renomeação falha e é tentado o seguinte.
+/// @param worker Nome do worker.
+/// @param shard Preenchido com o shard reservado.
+/// @return False se não houver shards por reservar.
+bool ShardSpool::claim(const std::string& worker, Shard& shard) {
+    for (const std::string& name : list("pending")) {
+        if (!endsWith(name, SHARD_SUFFIX)) continue;
+        fs::path target = directory / "running" / (name + "." + worker);
+        std::error_code error;
+        fs::rename(directory / "pending" / name, target, error);
+        if (error) continue;
+
+        shard.id = name.substr(0, name.size() - (sizeof(SHARD_SUFFIX) - 1));
+        shard.path = target.string();
+        if (!readFile(shard.path, shard.payload)) continue;
+        return true;
+    }
+    return false;
+}
+
+/// @brief Sinal de vida de um shard em execução: atualiza a data de modificação do seu ficheiro.
+void ShardSpool::heartbeat(const Shard& shard) const {
+    std::error_code error;
+    fs::last_write_time(shard.path, fs::file_time_type::clock::now(), error);
+}
+
+/// @brief Publica o resultado de um shard e apaga o seu ficheiro em running/.
+/// Formato: uma linha chave=valor por campo; o caminho é a lista de vértices separados por espaços.
+bool ShardSpool::complete(const Shard& shard, const ShardResult& result) {
+    std::ostringstream out;
+    out << std::setprecision(17);
+    out << "worker=" << result.worker << "\n";
+    out << "cost=" << formatCost(result.cost) << "\n";
+    out << "seconds=" << result.seconds << "\n";
+    out << "nodes=" << result.nodes << "\n";
+    out << "gap_reached=" << (result.gap_reached ? 1 : 0) << "\n";
+    if (!result.error.empty()) out << "error=" << result.error << "\n";
+    out << "path=";
+    for (size_t i = 0; i < result.path.size(); i++) out << (i ? " " : "") << result.path[i];
+    out << "\n";
+    bool written = writeFile((directory / "done" / (shard.id + RESULT_SUFFIX)).string(), out.str());
+    std::error_code error;
+    fs::remove(shard.path, error);
+    return written;
+}
+
+/// @brief Lê os resultados que ainda não tinham sido lidos.
+/// Um shard devolvido à fila e depois terminado por dois workers só conta uma vez; a cópia que ainda estiver por
+/// reservar é apagada.
+std::vector<ShardResult> ShardSpool::collectResults() {
+    std::vector<ShardResult> results;
+    for (const std::string& name : list("done")) {
+        if (!endsWith(name, RESULT_SUFFIX)) continue;
+        std::string id = name.substr(0, name.size() - (sizeof(RESULT_SUFFIX) - 1));
+        if (finished.count(id)) continue;
+
+        std::string bytes;
+        if (!readFile((directory / "done" / name).string(), bytes)) continue;
+        ShardResult result;
+        result.id = id;
+        std::istringstream in(bytes);
+        std::string line;
+        while (std::getline(in, line)) {
+            size_t equals = line.find('=');
+            if (equals == std::string::npos) continue;
+            std::string key = line.substr(0, equals), value = line.substr(equals + 1);
+            if (key == "worker") result.worker = value;
+            else if (key == "cost") result.cost = parseCost(value);
+            else if (key == "seconds") result.seconds = std::stod(value);
+            else if (key == "nodes") result.nodes = std::stoll(value);
+            else if (key == "gap_reached") result.gap_reached = value == "1";
+            else if (key == "error") result.error = value;
+            else if (key == "path") {
+                std::istringstream vertices(value);
+                int v;
+                while (vertices >> v) result.path.push_back(v);
+            }
+        }
+        finished.insert(id);
+        std::error_code error;
+        fs::remove(pendingPath(id), error);
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+/// @brief Devolve à fila os shards em execução cujo ficheiro não mudou durante seconds segundos (medidos no relógio
+/// do coordenador), por exemplo porque o worker morreu ou a máquina caiu. Na pesquisa exata o shard continua a partir
+/// do último checkpoint escrito pelo worker.
+/// @param seconds Tempo sem sinais de vida.
+/// @return Número de shards devolvidos à fila.
+int ShardSpool::requeueStale(double seconds) {
+    auto now = std::chrono::steady_clock::now();
+    std::set<std::string> running;
+    int requeued = 0;
+    for (const std::string& name : list("running")) {
+        running.insert(name);
+        fs::path file = directory / "running" / name;
+        std::error_code error;
+        fs::file_time_type modified = fs::last_write_time(file, error);
+        if (error) continue;
+
+        auto it = seen.find(name);
+        if (it == seen.end() || it->second.first != modified) {
+            seen[name] = std::make_pair(modified, now);
+            continue;
+        }
+        if (std::chrono::duration<double>(now - it->second.second).count() < seconds) continue;
+
+        size_t shard_end = name.find(SHARD_SUFFIX);
+        std::string id = name.substr(0, shard_end);
+        if (finished.count(id)) fs::remove(file, error);
+        else fs::rename(file, pendingPath(id), error);
+        if (!error && !finished.count(id)) requeued++;
+        seen.erase(name);
+    }
+    for (auto it = seen.begin(); it != seen.end();) {
+        if (running.count(it->first)) ++it;
+        else it = seen.erase(it);
+    }
+    return requeued;
+}
+
+void ShardSpool::publishIncumbent(double cost) {
+    writeFile((directory / "incumbent").string(), formatCost(cost) + "\n");
+}
+
+/// @brief Custo do melhor ciclo publicado pelo coordenador (infinito se ainda não houver).
+double ShardSpool::readIncumbent() const {
+    std::string bytes;
+    if (!readFile((directory / "incumbent").string(), bytes)) return std::numeric_limits<double>::infinity();
+    std::istringstream in(bytes);
+    std::string value;
+    if (!(in >> value)) return std::numeric_limits<double>::infinity();
+    return parseCost(value);
+}
+
+void ShardSpool::requestStop() {
+    writeFile((directory / "stop").string(), "stop\n");
+}
+
+/// @brief True se o coordenador pediu para parar ou se o trabalho deixou de existir.
+bool ShardSpool::stopRequested() const {
+    std::error_code error;
+    return fs::exists(directory / "stop", error) || !fs::exists(directory / "job", error);
+}
+
+size_t ShardSpool::pendingCount() const {
+    return list("pending").size();
+}
+
+size_t ShardSpool::runningCount() const {
+    return list("running").size();
+}
+
+/// @brief Nome único de um worker: máquina e processo.
+std::string ShardSpool::workerName() {
+    char host[256] = {0};
+    if (gethostname(host, sizeof(host) - 1) != 0) host[0] = 0;
+    std::string name = host[0] ? host : "host";
+    std::replace(name.begin(), name.end(), '.', '_');
+    return name + "-" + std::to_string(getpid());
+}
@@ -0,0 +1,102 @@
+#ifndef PROJETO2DA_SHARD_SPOOL_H
+#define PROJETO2DA_SHARD_SPOOL_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <chrono>
+#include <limits>
+#include <filesystem>
+
+// intervalo entre sinais de vida de um worker (segundos)
+#define SHARD_HEARTBEAT_SECONDS 1.0
+// um shard em execução sem sinais de vida durante este tempo volta à fila (segundos)
+#define SHARD_STALE_SECONDS 10.0
+// intervalo entre checkpoints de um shard da pesquisa exata (segundos)
+#define SHARD_CHECKPOINT_SECONDS 5.0
+// intervalo entre consultas do coordenador à pasta partilhada (segundos)
+#define SHARD_POLL_SECONDS 0.1
+// vezes que o coordenador volta a lançar o mesmo worker local antes de desistir dele
+#define SHARD_MAX_RESTARTS 3
+
+// trabalho partilhado por todos os shards: o problema e o grafo, que cada worker lê dos mesmos ficheiros
+struct ShardJob {
+    std::string kind;          // "nearest-neighbor", "ant-colony" ou "backtracking"
+    std::string nodes_file;    // vazio se o grafo estiver num único ficheiro
+    std::string edges_file;
+    double time_limit = 0.0;   // prazo de cada shard de metaheurística (segundos)
+    double gap_threshold = 0.0;
+    double lower_bound = 0.0;
+};
+
+// shard reservado por um worker
+struct Shard {
+    std::string id;
+    std::string path;          // ficheiro em running/, de que o worker é dono enquanto o shard corre
+    std::string payload;       // conteúdo do shard (texto, ou um SearchCheckpoint na pesquisa exata)
+};
+
+// resultado de um shard
+struct ShardResult {
+    std::string id;
+    std::string worker;
+    double cost = std::numeric_limits<double>::infinity();   // infinito se o shard não tiver encontrado nenhum ciclo
+    std::vector<int> path;
+    double seconds = 0.0;
+    long long nodes = 0;       // nós expandidos (pesquisa exata)
+    bool gap_reached = false;
+    std::string error;         // vazio se o shard foi explorado; senão o motivo (o shard não conta como resolvido)
+};
+
+// protocolo coordenador/workers sobre uma pasta partilhada (local ou montada em várias máquinas):
+//   job                     trabalho (ShardJob, texto chave=valor)
+//   pending/<id>.shard      shards por reservar
+//   running/<id>.shard.<w>  shards reservados pelo worker w (reservar é renomear, o que é atómico); o worker atualiza
+//                           a data de modificação (sinal de vida) e, na pesquisa exata, reescreve o checkpoint
+//   done/<id>.result        resultados (texto)
+//   incumbent               custo do melhor ciclo conhecido, publicado pelo coordenador
+//   stop                    pedido de paragem aos workers
+// Todos os ficheiros são escritos numa cópia .tmp e renomeados, para nunca serem lidos a meio da escrita.
+class ShardSpool {
+public:
+    explicit ShardSpool(const std::string& directory);
+
+    const std::string& getDirectory() const;
+
+    // coordenador
+    bool create(const ShardJob& job);
+    std::string pendingPath(const std::string& id) const;
+    bool addShard(const std::string& id, const std::string& payload);
+    std::vector<ShardResult> collectResults();
+    int requeueStale(double seconds);
+    void publishIncumbent(double cost);
+    void requestStop();
+    size_t pendingCount() const;
+    size_t runningCount() const;
+
+    // worker
+    bool readJob(ShardJob& job) const;
+    bool claim(const std::string& worker, Shard& shard);
+    void heartbeat(const Shard& shard) const;
+    bool complete(const Shard& shard, const ShardResult& result);
+    double readIncumbent() const;
+    bool stopRequested() const;
+
+    static std::string workerName();
+
+    static bool writeFile(const std::string& file, const std::string& bytes);
+    static bool readFile(const std::string& file, std::string& bytes);
+
+private:
+    std::vector<std::string> list(const std::string& folder) const;
+
+    std::filesystem::path directory;
+
+    // coordenador: última data de modificação vista de cada shard em execução e quando mudou (relógio do coordenador,
+    // para que relógios diferentes entre máquinas não contem)
+    std::map<std::string, std::pair<std::filesystem::file_time_type, std::chrono::steady_clock::time_point>> seen;
+    std::set<std::string> finished;
+};
+
+#endif //PROJETO2DA_SHARD_SPOOL_H
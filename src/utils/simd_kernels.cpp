@@ -0,0 +1,134 @@
+#include "simd_kernels.h"
+
+#include <atomic>
+
+#ifdef SIMD_KERNELS_AVX512
+namespace simd_avx512 {
+int maskedArgmin(const double* row, const uint64_t* masked, int n);
+int maskedArgmin(const float* row, const uint64_t* masked, int n);
+int maskedArgmin(const int32_t* row, const uint64_t* masked, int n);
+void relaxKeys(const double* row, const uint64_t* in_tree, double* key, int* parent, int u, int n);
+void relaxKeys(const float* row, const uint64_t* in_tree, float* key, int* parent, int u, int n);
+void relaxKeys(const int32_t* row, const uint64_t* in_tree, int32_t* key, int* parent, int u, int n);
+}
+#endif
+
+#ifdef SIMD_KERNELS_AVX2
+namespace simd_avx2 {
+int maskedArgmin(const double* row, const uint64_t* masked, int n);
+int maskedArgmin(const float* row, const uint64_t* masked, int n);
+int maskedArgmin(const int32_t* row, const uint64_t* masked, int n);
+void relaxKeys(const double* row, const uint64_t* in_tree, double* key, int* parent, int u, int n);
+void relaxKeys(const float* row, const uint64_t* in_tree, float* key, int* parent, int u, int n);
+void relaxKeys(const int32_t* row, const uint64_t* in_tree, int32_t* key, int* parent, int u, int n);
+}
+#endif
+
+namespace {
+
+template<typename T>
+int scalarArgmin(const T* row, const uint64_t* masked, int n) {
+    int best = -1;
+    for (int i = 0; i < n; i++) {
+        if ((masked[i >> 6] >> (i & 63)) & 1) continue;
+        if (best == -1 || row[i] < row[best]) best = i;
+    }
+    return best;
+}
+
+template<typename T>
+void scalarRelax(const T* row, const uint64_t* in_tree, T* key, int* parent, int u, int n) {
+    for (int i = 0; i < n; i++) {
+        if ((in_tree[i >> 6] >> (i & 63)) & 1) continue;
+        if (row[i] < key[i]) {
+            key[i] = row[i];
+            parent[i] = u;
+        }
+    }
+}
+
+std::atomic<int> active_level{-1};
+
+SimdLevel currentLevel() {
+    int level = active_level.load(std::memory_order_relaxed);
+    if (level < 0) {
+        level = (int)detectedSimdLevel();
+        active_level.store(level, std::memory_order_relaxed);
+    }
+    return (SimdLevel)level;
+}
+
+template<typename T>
+int dispatchArgmin(const T* row, const uint64_t* masked, int n) {
+    switch (currentLevel()) {
+#ifdef SIMD_KERNELS_AVX512
+        case SimdLevel::Avx512: return simd_avx512::maskedArgmin(row, masked, n);
+#endif
+#ifdef SIMD_KERNELS_AVX2
+        case SimdLevel::Avx2: return simd_avx2::maskedArgmin(row, masked, n);
+#endif
+        default: return scalarArgmin(row, masked, n);
+    }
+}
+
+template<typename T>
+void dispatchRelax(const T* row, const uint64_t* in_tree, T* key, int* parent, int u, int n) {
+    switch (currentLevel()) {
+#ifdef SIMD_KERNELS_AVX512
+        case SimdLevel::Avx512: simd_avx512::relaxKeys(row, in_tree, key, parent, u, n); return;
+#endif
+#ifdef SIMD_KERNELS_AVX2
+        case SimdLevel::Avx2: simd_avx2::relaxKeys(row, in_tree, key, parent, u, n); return;
+#endif
+        default: scalarRelax(row, in_tree, key, parent, u, n);
+    }
+}
+
+}
+
+/// @brief Melhor conjunto de instruções disponível, entre os compilados neste executável e os suportados pelo processador.
+SimdLevel detectedSimdLevel() {
+#if defined(SIMD_KERNELS_AVX512) || defined(SIMD_KERNELS_AVX2)
+    __builtin_cpu_init();
+#endif
+#ifdef SIMD_KERNELS_AVX512
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::Avx512;
+#endif
+#ifdef SIMD_KERNELS_AVX2
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::Avx2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+SimdLevel simdLevel() {
+    return currentLevel();
+}
+
+/// @brief Escolhe a implementação dos kernels; um nível acima do detetado é reduzido ao detetado.
+void setSimdLevel(SimdLevel level) {
+    SimdLevel detected = detectedSimdLevel();
+    if ((int)level > (int)detected) level = detected;
+    active_level.store((int)level, std::memory_order_relaxed);
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Avx512: return "AVX-512";
+        case SimdLevel::Avx2: return "AVX2";
+        default: return "scalar";
+    }
+}
+
+int maskedArgmin(const double* row, const uint64_t* masked, int n) { return dispatchArgmin(row, masked, n); }
+int maskedArgmin(const float* row, const uint64_t* masked, int n) { return dispatchArgmin(row, masked, n); }
+int maskedArgmin(const int32_t* row, const uint64_t* masked, int n) { return dispatchArgmin(row, masked, n); }
+
+void relaxKeys(const double* row, const uint64_t* in_tree, double* key, int* parent, int u, int n) {
+    dispatchRelax(row, in_tree, key, parent, u, n);
+}
+void relaxKeys(const float* row, const uint64_t* in_tree, float* key, int* parent, int u, int n) {
+    dispatchRelax(row, in_tree, key, parent, u, n);
+}
+void relaxKeys(const int32_t* row, const uint64_t* in_tree, int32_t* key, int* parent, int u, int n) {
+    dispatchRelax(row, in_tree, key, parent, u, n);
+}
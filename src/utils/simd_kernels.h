@@ -0,0 +1,38 @@
+#ifndef PROJETO2DA_SIMD_KERNELS_H
+#define PROJETO2DA_SIMD_KERNELS_H
+
+#include <cstdint>
+#include <vector>
+
+// kernels vetorizados para os ciclos internos densos do vizinho mais próximo e de Prim; a implementação (AVX-512,
+// AVX2 ou escalar) é escolhida em tempo de execução conforme o processador
+enum class SimdLevel { Scalar = 0, Avx2 = 1, Avx512 = 2 };
+
+// melhor nível suportado pelo processador e pelo compilador
+SimdLevel detectedSimdLevel();
+
+// nível em uso (por omissão o detetado)
+SimdLevel simdLevel();
+
+// força um nível (limitado ao detetado); usado pelos microbenchmarks
+void setSimdLevel(SimdLevel level);
+
+const char* simdLevelName(SimdLevel level);
+
+// máscara de bits com uma posição por vértice
+inline std::vector<uint64_t> makeBitmask(int n) { return std::vector<uint64_t>((n + 63) / 64, 0); }
+inline void setBit(std::vector<uint64_t>& bits, int i) { bits[i >> 6] |= (uint64_t)1 << (i & 63); }
+inline bool testBit(const std::vector<uint64_t>& bits, int i) { return (bits[i >> 6] >> (i & 63)) & 1; }
+
+// índice do menor valor de row[0..n) entre as posições sem bit em masked (o menor índice em caso de empate);
+// -1 se todas as posições estiverem marcadas
+int maskedArgmin(const double* row, const uint64_t* masked, int n);
+int maskedArgmin(const float* row, const uint64_t* masked, int n);
+int maskedArgmin(const int32_t* row, const uint64_t* masked, int n);
+
+// passo de Prim denso: para cada v sem bit em in_tree com row[v] < key[v], key[v] = row[v] e parent[v] = u
+void relaxKeys(const double* row, const uint64_t* in_tree, double* key, int* parent, int u, int n);
+void relaxKeys(const float* row, const uint64_t* in_tree, float* key, int* parent, int u, int n);
+void relaxKeys(const int32_t* row, const uint64_t* in_tree, int32_t* key, int* parent, int u, int n);
+
+#endif //PROJETO2DA_SIMD_KERNELS_H
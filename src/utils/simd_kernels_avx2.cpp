@@ -0,0 +1,122 @@
+// implementação AVX2 dos kernels de simd_kernels.h; compilado com -mavx2 e só chamado se o processador o suportar
+
+#include "simd_kernels_impl.h"
+
+#include <immintrin.h>
+
+namespace {
+
+// máscaras de faixa (todos os bits a 1 nas faixas marcadas) a partir dos bits de um bloco
+inline __m256i laneMask32(unsigned bits) {
+    const __m256i select = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32((int)bits), select), select);
+}
+
+inline __m256i laneMask64(unsigned bits) {
+    const __m256i select = _mm256_setr_epi64x(1, 2, 4, 8);
+    return _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(bits), select), select);
+}
+
+struct OpsDouble {
+    using T = double;
+    using V = __m256d;
+    static const int W = 4;
+
+    static V fill(T x) { return _mm256_set1_pd(x); }
+    static V loadFree(const T* p, unsigned free, V other) {
+        return _mm256_blendv_pd(other, _mm256_loadu_pd(p), _mm256_castsi256_pd(laneMask64(free)));
+    }
+    static V min(V a, V b) { return _mm256_min_pd(a, b); }
+    static T reduce(V v) {
+        __m128d m = _mm_min_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        m = _mm_min_sd(m, _mm_unpackhi_pd(m, m));
+        return _mm_cvtsd_f64(m);
+    }
+    static unsigned equal(const T* p, T x, unsigned free) {
+        return _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(p), _mm256_set1_pd(x), _CMP_EQ_OQ)) & free;
+    }
+    static unsigned relax(const T* row, T* key, unsigned free) {
+        V r = _mm256_loadu_pd(row), k = _mm256_loadu_pd(key);
+        V less = _mm256_and_pd(_mm256_cmp_pd(r, k, _CMP_LT_OQ), _mm256_castsi256_pd(laneMask64(free)));
+        unsigned updated = _mm256_movemask_pd(less);
+        if (updated) _mm256_storeu_pd(key, _mm256_blendv_pd(k, r, less));
+        return updated;
+    }
+};
+
+struct OpsFloat {
+    using T = float;
+    using V = __m256;
+    static const int W = 8;
+
+    static V fill(T x) { return _mm256_set1_ps(x); }
+    static V loadFree(const T* p, unsigned free, V other) {
+        return _mm256_blendv_ps(other, _mm256_loadu_ps(p), _mm256_castsi256_ps(laneMask32(free)));
+    }
+    static V min(V a, V b) { return _mm256_min_ps(a, b); }
+    static T reduce(V v) {
+        __m128 m = _mm_min_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+        m = _mm_min_ss(m, _mm_shuffle_ps(m, m, 1));
+        return _mm_cvtss_f32(m);
+    }
+    static unsigned equal(const T* p, T x, unsigned free) {
+        return _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(p), _mm256_set1_ps(x), _CMP_EQ_OQ)) & free;
+    }
+    static unsigned relax(const T* row, T* key, unsigned free) {
+        V r = _mm256_loadu_ps(row), k = _mm256_loadu_ps(key);
+        V less = _mm256_and_ps(_mm256_cmp_ps(r, k, _CMP_LT_OQ), _mm256_castsi256_ps(laneMask32(free)));
+        unsigned updated = _mm256_movemask_ps(less);
+        if (updated) _mm256_storeu_ps(key, _mm256_blendv_ps(k, r, less));
+        return updated;
+    }
+};
+
+struct OpsInt32 {
+    using T = int32_t;
+    using V = __m256i;
+    static const int W = 8;
+
+    static V fill(T x) { return _mm256_set1_epi32(x); }
+    static V loadFree(const T* p, unsigned free, V other) {
+        return _mm256_blendv_epi8(other, _mm256_loadu_si256((const __m256i*)p), laneMask32(free));
+    }
+    static V min(V a, V b) { return _mm256_min_epi32(a, b); }
+    static T reduce(V v) {
+        __m128i m = _mm_min_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+        m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(m);
+    }
+    static unsigned equal(const T* p, T x, unsigned free) {
+        __m256i eq = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)p), _mm256_set1_epi32(x));
+        return _mm256_movemask_ps(_mm256_castsi256_ps(eq)) & free;
+    }
+    static unsigned relax(const T* row, T* key, unsigned free) {
+        V r = _mm256_loadu_si256((const __m256i*)row), k = _mm256_loadu_si256((const __m256i*)key);
+        V less = _mm256_and_si256(_mm256_cmpgt_epi32(k, r), laneMask32(free));
+        unsigned updated = _mm256_movemask_ps(_mm256_castsi256_ps(less));
+        if (updated) _mm256_storeu_si256((__m256i*)key, _mm256_blendv_epi8(k, r, less));
+        return updated;
+    }
+};
+
+}
+
+namespace simd_avx2 {
+
+int maskedArgmin(const double* row, const uint64_t* masked, int n) { return argminImpl<OpsDouble>(row, masked, n); }
+int maskedArgmin(const float* row, const uint64_t* masked, int n) { return argminImpl<OpsFloat>(row, masked, n); }
+int maskedArgmin(const int32_t* row, const uint64_t* masked, int n) { return argminImpl<OpsInt32>(row, masked, n); }
+
+void relaxKeys(const double* row, const uint64_t* in_tree, double* key, int* parent, int u, int n) {
+    relaxImpl<OpsDouble>(row, in_tree, key, parent, u, n);
+}
+void relaxKeys(const float* row, const uint64_t* in_tree, float* key, int* parent, int u, int n) {
+    relaxImpl<OpsFloat>(row, in_tree, key, parent, u, n);
+}
+void relaxKeys(const int32_t* row, const uint64_t* in_tree, int32_t* key, int* parent, int u, int n) {
+    relaxImpl<OpsInt32>(row, in_tree, key, parent, u, n);
+}
+
+}
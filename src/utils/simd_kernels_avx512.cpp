@@ -0,0 +1,100 @@
+// implementação AVX-512 dos kernels de simd_kernels.h; compilado com -mavx512f e só chamado se o processador o suportar
+
+#include "simd_kernels_impl.h"
+
+#include <immintrin.h>
+
+// GCC's avx512fintrin.h builds the "undefined" operands of _mm512_min_* and of the reductions from self-initialised
+// locals, which -Wall reports as (maybe-)uninitialised once they are inlined into these kernels; the warning is about
+// the header, so it is silenced for this file only
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace {
+
+struct OpsDouble {
+    using T = double;
+    using V = __m512d;
+    static const int W = 8;
+
+    static V fill(T x) { return _mm512_set1_pd(x); }
+    static V loadFree(const T* p, unsigned free, V other) { return _mm512_mask_loadu_pd(other, (__mmask8)free, p); }
+    static V min(V a, V b) { return _mm512_min_pd(a, b); }
+    static T reduce(V v) { return _mm512_reduce_min_pd(v); }
+    static unsigned equal(const T* p, T x, unsigned free) {
+        return _mm512_mask_cmp_pd_mask((__mmask8)free, _mm512_loadu_pd(p), _mm512_set1_pd(x), _CMP_EQ_OQ);
+    }
+    static unsigned relax(const T* row, T* key, unsigned free) {
+        V r = _mm512_loadu_pd(row);
+        __mmask8 less = _mm512_mask_cmp_pd_mask((__mmask8)free, r, _mm512_loadu_pd(key), _CMP_LT_OQ);
+        _mm512_mask_storeu_pd(key, less, r);
+        return less;
+    }
+};
+
+struct OpsFloat {
+    using T = float;
+    using V = __m512;
+    static const int W = 16;
+
+    static V fill(T x) { return _mm512_set1_ps(x); }
+    static V loadFree(const T* p, unsigned free, V other) { return _mm512_mask_loadu_ps(other, (__mmask16)free, p); }
+    static V min(V a, V b) { return _mm512_min_ps(a, b); }
+    static T reduce(V v) { return _mm512_reduce_min_ps(v); }
+    static unsigned equal(const T* p, T x, unsigned free) {
+        return _mm512_mask_cmp_ps_mask((__mmask16)free, _mm512_loadu_ps(p), _mm512_set1_ps(x), _CMP_EQ_OQ);
+    }
+    static unsigned relax(const T* row, T* key, unsigned free) {
+        V r = _mm512_loadu_ps(row);
+        __mmask16 less = _mm512_mask_cmp_ps_mask((__mmask16)free, r, _mm512_loadu_ps(key), _CMP_LT_OQ);
+        _mm512_mask_storeu_ps(key, less, r);
+        return less;
+    }
+};
+
+struct OpsInt32 {
+    using T = int32_t;
+    using V = __m512i;
+    static const int W = 16;
+
+    static V fill(T x) { return _mm512_set1_epi32(x); }
+    static V loadFree(const T* p, unsigned free, V other) { return _mm512_mask_loadu_epi32(other, (__mmask16)free, p); }
+    static V min(V a, V b) { return _mm512_min_epi32(a, b); }
+    static T reduce(V v) { return _mm512_reduce_min_epi32(v); }
+    static unsigned equal(const T* p, T x, unsigned free) {
+        return _mm512_mask_cmpeq_epi32_mask((__mmask16)free, _mm512_loadu_si512(p), _mm512_set1_epi32(x));
+    }
+    static unsigned relax(const T* row, T* key, unsigned free) {
+        V r = _mm512_loadu_si512(row);
+        __mmask16 less = _mm512_mask_cmplt_epi32_mask((__mmask16)free, r, _mm512_loadu_si512(key));
+        _mm512_mask_storeu_epi32(key, less, r);
+        return less;
+    }
+};
+
+}
+
+namespace simd_avx512 {
+
+int maskedArgmin(const double* row, const uint64_t* masked, int n) { return argminImpl<OpsDouble>(row, masked, n); }
+int maskedArgmin(const float* row, const uint64_t* masked, int n) { return argminImpl<OpsFloat>(row, masked, n); }
+int maskedArgmin(const int32_t* row, const uint64_t* masked, int n) { return argminImpl<OpsInt32>(row, masked, n); }
+
+void relaxKeys(const double* row, const uint64_t* in_tree, double* key, int* parent, int u, int n) {
+    relaxImpl<OpsDouble>(row, in_tree, key, parent, u, n);
+}
+void relaxKeys(const float* row, const uint64_t* in_tree, float* key, int* parent, int u, int n) {
+    relaxImpl<OpsFloat>(row, in_tree, key, parent, u, n);
+}
+void relaxKeys(const int32_t* row, const uint64_t* in_tree, int32_t* key, int* parent, int u, int n) {
+    relaxImpl<OpsInt32>(row, in_tree, key, parent, u, n);
+}
+
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
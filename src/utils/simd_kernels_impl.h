@@ -0,0 +1,84 @@
+#ifndef PROJETO2DA_SIMD_KERNELS_IMPL_H
+#define PROJETO2DA_SIMD_KERNELS_IMPL_H
+
+// algoritmos comuns às implementações vetorizadas; cada unidade de compilação (compilada com as flags do seu conjunto
+// de instruções) define as operações Ops e instancia estes templates num namespace anónimo, para que nenhum código
+// com essas instruções seja partilhado com o resto do programa
+
+#include <cstdint>
+#include <limits>
+
+namespace {
+
+// bits de masked para as posições i..i+width-1 (i múltiplo de width, width divide 64)
+inline unsigned maskBits(const uint64_t* masked, int i, int width) {
+    uint64_t all = width == 64 ? ~(uint64_t)0 : (((uint64_t)1 << width) - 1);
+    return (unsigned)((masked[i >> 6] >> (i & 63)) & all);
+}
+
+inline bool maskBit(const uint64_t* masked, int i) {
+    return (masked[i >> 6] >> (i & 63)) & 1;
+}
+
+// Ops: T, V, W, fill(x), loadFree(p, free, other), min(a, b), reduce(v), equal(p, x, free), relax(row, key, free)
+// (free tem um bit por posição não marcada; equal e relax devolvem os bits das posições iguais / atualizadas)
+template<class Ops>
+int argminImpl(const typename Ops::T* row, const uint64_t* masked, int n) {
+    using T = typename Ops::T;
+    const int W = Ops::W;
+    const unsigned full = (1u << W) - 1;
+    const T neutral = std::numeric_limits<T>::max();
+
+    typename Ops::V best = Ops::fill(neutral);
+    bool any = false;
+    int blocks = n / W * W;
+    for (int i = 0; i < blocks; i += W) {
+        unsigned free = ~maskBits(masked, i, W) & full;
+        any |= free != 0;
+        best = Ops::min(best, Ops::loadFree(row + i, free, Ops::fill(neutral)));
+    }
+    T minimum = Ops::reduce(best);
+    for (int i = blocks; i < n; i++) {
+        if (maskBit(masked, i)) continue;
+        any = true;
+        if (row[i] < minimum) minimum = row[i];
+    }
+    if (!any) return -1;
+
+    // second pass: first free position holding the minimum
+    for (int i = 0; i < blocks; i += W) {
+        unsigned free = ~maskBits(masked, i, W) & full;
+        unsigned hit = Ops::equal(row + i, minimum, free);
+        if (hit) return i + __builtin_ctz(hit);
+    }
+    for (int i = blocks; i < n; i++) {
+        if (!maskBit(masked, i) && row[i] == minimum) return i;
+    }
+    return -1;
+}
+
+template<class Ops>
+void relaxImpl(const typename Ops::T* row, const uint64_t* in_tree, typename Ops::T* key, int* parent, int u, int n) {
+    const int W = Ops::W;
+    const unsigned full = (1u << W) - 1;
+    int blocks = n / W * W;
+    for (int i = 0; i < blocks; i += W) {
+        unsigned free = ~maskBits(in_tree, i, W) & full;
+        if (!free) continue;
+        unsigned updated = Ops::relax(row + i, key + i, free);
+        while (updated) {
+            parent[i + __builtin_ctz(updated)] = u;
+            updated &= updated - 1;
+        }
+    }
+    for (int i = blocks; i < n; i++) {
+        if (!maskBit(in_tree, i) && row[i] < key[i]) {
+            key[i] = row[i];
+            parent[i] = u;
+        }
+    }
+}
+
+}
+
+#endif //PROJETO2DA_SIMD_KERNELS_IMPL_H
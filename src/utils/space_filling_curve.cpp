@@ -0,0 +1,65 @@
+#include "space_filling_curve.h"
+
+#include <algorithm>
+#include <thread>
+
+/// @brief Calcula a posição de uma célula na curva de Hilbert.
+/// Esta função tem complexidade O(CURVE_BITS).
+/// @param x Coluna da célula, em [0, 2^CURVE_BITS).
+/// @param y Linha da célula, em [0, 2^CURVE_BITS).
+/// @return Posição na curva.
+uint64_t hilbertIndex(uint32_t x, uint32_t y) {
+    const uint32_t side = 1u << CURVE_BITS;
+    uint64_t d = 0;
+    for (uint32_t s = side / 2; s > 0; s /= 2) {
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        d += (uint64_t)s * s * ((3 * rx) ^ ry);
+
+        // rotate the quadrant so that the curve keeps its orientation
+        if (ry == 0) {
+            if (rx == 1) {
+                x = side - 1 - x;
+                y = side - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+/// @brief Calcula os índices de Hilbert de um conjunto de pontos.
+/// As coordenadas são normalizadas pela bounding box dos pontos para a grelha de 2^CURVE_BITS células por eixo.
+/// Os pontos são divididos em blocos contíguos, um por thread.
+/// Esta função tem complexidade O(n * CURVE_BITS / T).
+/// @param xs Primeira coordenada de cada ponto.
+/// @param ys Segunda coordenada de cada ponto.
+/// @param num_threads Número de threads.
+/// @return Índice de Hilbert de cada ponto.
+std::vector<uint64_t> hilbertIndices(const std::vector<double>& xs, const std::vector<double>& ys, int num_threads) {
+    size_t n = xs.size();
+    std::vector<uint64_t> indices(n, 0);
+    if (n == 0) return indices;
+
+    double min_x = *std::min_element(xs.begin(), xs.end()), max_x = *std::max_element(xs.begin(), xs.end());
+    double min_y = *std::min_element(ys.begin(), ys.end()), max_y = *std::max_element(ys.begin(), ys.end());
+    double span = std::max(max_x - min_x, max_y - min_y);
+    double scale = span > 0 ? ((1u << CURVE_BITS) - 1) / span : 0.0;
+
+    auto work = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            uint32_t x = (uint32_t)((xs[i] - min_x) * scale);
+            uint32_t y = (uint32_t)((ys[i] - min_y) * scale);
+            indices[i] = hilbertIndex(x, y);
+        }
+    };
+
+    num_threads = std::max(1, std::min(num_threads, (int)(n / 4096) + 1));
+    std::vector<std::thread> workers;
+    for (int t = 1; t < num_threads; t++) {
+        workers.emplace_back(work, n * t / num_threads, n * (t + 1) / num_threads);
+    }
+    work(0, n / num_threads);
+    for (std::thread& worker : workers) worker.join();
+    return indices;
+}
@@ -0,0 +1,18 @@
+#ifndef PROJETO2DA_SPACE_FILLING_CURVE_H
+#define PROJETO2DA_SPACE_FILLING_CURVE_H
+
+#include <cstdint>
+#include <vector>
+
+// número de bits por coordenada na grelha da curva (2^16 x 2^16 células)
+#ifndef CURVE_BITS
+#define CURVE_BITS 16
+#endif
+
+// posição na curva de Hilbert da célula (x, y) de uma grelha 2^CURVE_BITS x 2^CURVE_BITS
+uint64_t hilbertIndex(uint32_t x, uint32_t y);
+
+// índices de Hilbert de pontos, depois de os normalizar para a grelha pela bounding box
+std::vector<uint64_t> hilbertIndices(const std::vector<double>& xs, const std::vector<double>& ys, int num_threads = 1);
+
+#endif //PROJETO2DA_SPACE_FILLING_CURVE_H
@@ -0,0 +1,61 @@
+#include "static_graph.h"
+
+/// @brief Escolhe e constrói a instanciação de StaticGraph adequada a um grafo carregado.
+/// Regras: sem arestas e com coordenadas usa armazenamento geométrico; grafos com densidade de pelo menos DENSE_MIN_DENSITY usam a matriz densa
+/// (float acima de DENSE_FLOAT_VERTICES vértices); os restantes usam CSR. Pesos todos inteiros usam int32 e
+/// grafos com alguma aresta sem a inversa são tratados como dirigidos.
+/// Esta função tem complexidade O(E log V) mais a construção do armazenamento escolhido.
+/// @param graph Grafo carregado pelo CsvReader.
+/// @return Grafo especializado, ou std::monostate se o grafo estiver vazio.
+AnyStaticGraph makeStaticGraph(const Graph& graph) {
+    int n = graph.getNumVertices();
+    if (n == 0) return std::monostate();
+
+    std::vector<std::vector<int>> sorted(n);
+    long long edges = 0;
+    bool integral = true;
+    for (int u = 0; u < n; u++) {
+        for (const edgeNode& edge : graph.getAdjacent(u)) {
+            if (edge.vertex == u) continue;
+            sorted[u].push_back(edge.vertex);
+            edges++;
+            if (edge.distance != std::floor(edge.distance) || std::fabs(edge.distance) > 2147483647.0) {
+                integral = false;
+            }
+        }
+        std::sort(sorted[u].begin(), sorted[u].end());
+    }
+
+    bool directed = false;
+    for (int u = 0; u < n && !directed; u++) {
+        for (int v : sorted[u]) {
+            if (!std::binary_search(sorted[v].begin(), sorted[v].end(), u)) {
+                directed = true;
+                break;
+            }
+        }
+    }
+
+    if (edges == 0) {
+        if (!graph.hasCoordinates()) return StaticGraph<CsrStorage, double, false>(graph);
+        if (n > DENSE_FLOAT_VERTICES) return StaticGraph<GeometricStorage, float, false>(graph);
+        return StaticGraph<GeometricStorage, double, false>(graph);
+    }
+
+    if (edges >= DENSE_MIN_DENSITY * n * (n - 1.0)) {
+        if (integral) {
+            if (directed) return StaticGraph<DenseStorage, int32_t, true>(graph);
+            return StaticGraph<DenseStorage, int32_t, false>(graph);
+        }
+        if (directed) return StaticGraph<DenseStorage, double, true>(graph);
+        if (n > DENSE_FLOAT_VERTICES) return StaticGraph<DenseStorage, float, false>(graph);
+        return StaticGraph<DenseStorage, double, false>(graph);
+    }
+
+    if (integral) {
+        if (directed) return StaticGraph<CsrStorage, int32_t, true>(graph);
+        return StaticGraph<CsrStorage, int32_t, false>(graph);
+    }
+    if (directed) return StaticGraph<CsrStorage, double, true>(graph);
+    return StaticGraph<CsrStorage, double, false>(graph);
+}
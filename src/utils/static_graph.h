@@ -0,0 +1,427 @@
+#ifndef PROJETO2DA_STATIC_GRAPH_H
+#define PROJETO2DA_STATIC_GRAPH_H
+
+#include <vector>
+#include <string>
+#include <variant>
+#include <cstdint>
+#include <type_traits>
+
+#include "graph.h"
+#include "simd_kernels.h"
+
+// conversão de uma distância para o tipo de peso escolhido
+template<typename Weight>
+inline Weight toWeight(double distance) {
+    if constexpr (std::is_integral<Weight>::value) {
+        return static_cast<Weight>(std::llround(distance));
+    } else {
+        return static_cast<Weight>(distance);
+    }
+}
+
+template<typename Weight>
+inline const char* weightName() {
+    if constexpr (std::is_same<Weight, float>::value) return "float";
+    else if constexpr (std::is_same<Weight, double>::value) return "double";
+    else return "int32";
+}
+
+// matriz densa n*n; usada em grafos (quase) completos. Os pares sem aresta guardam NO_EDGE, não são vizinhos
+// e custam a distância haversine, como em Graph::travelCost
+template<typename Weight>
+class DenseStorage {
+public:
+    static constexpr const char* name = "dense";
+    static constexpr Weight NO_EDGE = std::numeric_limits<Weight>::max();
+
+    void build(const Graph& graph, bool directed) {
+        n = graph.getNumVertices();
+        matrix.assign((size_t)n * n, NO_EDGE);
+        lat.resize(n);
+        lon.resize(n);
+        for (int u = 0; u < n; u++) {
+            lat[u] = graph.getLat(u);
+            lon[u] = graph.getLongi(u);
+            for (const edgeNode& edge : graph.getAdjacent(u)) {
+                matrix[(size_t)u * n + edge.vertex] = toWeight<Weight>(edge.distance);
+                if (!directed && matrix[(size_t)edge.vertex * n + u] == NO_EDGE) {
+                    matrix[(size_t)edge.vertex * n + u] = toWeight<Weight>(edge.distance);
+                }
+            }
+        }
+    }
+
+    int size() const { return n; }
+
+    Weight weight(int u, int v) const {
+        Weight w = matrix[(size_t)u * n + v];
+        if (w != NO_EDGE) return w;
+        return u == v ? Weight(0) : toWeight<Weight>(Graph::haversine(lat[u], lon[u], lat[v], lon[v]));
+    }
+
+    template<typename F>
+    void forEachNeighbour(int u, F&& f) const {
+        const Weight* row = &matrix[(size_t)u * n];
+        for (int v = 0; v < n; v++) {
+            if (v != u && row[v] != NO_EDGE) f(v, row[v]);
+        }
+    }
+
+    const Weight* row(int u) const { return &matrix[(size_t)u * n]; }
+
+    size_t memoryFootprint() const {
+        return matrix.capacity() * sizeof(Weight) + (lat.capacity() + lon.capacity()) * sizeof(double);
+    }
+
+private:
+    int n = 0;
+    std::vector<Weight> matrix;
+    std::vector<double> lat;
+    std::vector<double> lon;
+};
+
+// compressed sparse row; pares não adjacentes custam a distância haversine, como em Graph::travelCost
+template<typename Weight>
+class CsrStorage {
+public:
+    static constexpr const char* name = "csr";
+
+    void build(const Graph& graph, bool directed) {
+        n = graph.getNumVertices();
+        std::vector<std::vector<std::pair<int, double>>> rows(n);
+        lat.resize(n);
+        lon.resize(n);
+        for (int u = 0; u < n; u++) {
+            lat[u] = graph.getLat(u);
+            lon[u] = graph.getLongi(u);
+            for (const edgeNode& edge : graph.getAdjacent(u)) {
+                rows[u].push_back(std::make_pair(edge.vertex, edge.distance));
+            }
+        }
+        if (!directed) {
+            // make sure every edge can be used in both directions
+            for (int u = 0; u < n; u++) {
+                for (const edgeNode& edge : graph.getAdjacent(u)) {
+                    bool has_reverse = false;
+                    for (const edgeNode& back : graph.getAdjacent(edge.vertex)) {
+                        if (back.vertex == u) {
+                            has_reverse = true;
+                            break;
+                        }
+                    }
+                    if (!has_reverse) rows[edge.vertex].push_back(std::make_pair(u, edge.distance));
+                }
+            }
+        }
+
+        offsets.assign(n + 1, 0);
+        for (int u = 0; u < n; u++) {
+            offsets[u + 1] = offsets[u] + rows[u].size();
+        }
+        targets.resize(offsets[n]);
+        weights.resize(offsets[n]);
+        for (int u = 0; u < n; u++) {
+            for (size_t i = 0; i < rows[u].size(); i++) {
+                targets[offsets[u] + i] = rows[u][i].first;
+                weights[offsets[u] + i] = toWeight<Weight>(rows[u][i].second);
+            }
+        }
+    }
+
+    int size() const { return n; }
+
+    Weight weight(int u, int v) const {
+        for (int i = offsets[u]; i < offsets[u + 1]; i++) {
+            if (targets[i] == v) return weights[i];
+        }
+        return toWeight<Weight>(Graph::haversine(lat[u], lon[u], lat[v], lon[v]));
+    }
+
+    template<typename F>
+    void forEachNeighbour(int u, F&& f) const {
+        for (int i = offsets[u]; i < offsets[u + 1]; i++) {
+            f(targets[i], weights[i]);
+        }
+    }
+
+    size_t memoryFootprint() const {
+        return (offsets.capacity() + targets.capacity()) * sizeof(int) + weights.capacity() * sizeof(Weight)
+             + (lat.capacity() + lon.capacity()) * sizeof(double);
+    }
+
+private:
+    int n = 0;
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<Weight> weights;
+    std::vector<double> lat;
+    std::vector<double> lon;
+};
+
+// grafo geométrico implícito: só guarda coordenadas e calcula a distância haversine quando é pedida
+template<typename Weight>
+class GeometricStorage {
+public:
+    static constexpr const char* name = "geometric";
+
+    void build(const Graph& graph, bool) {
+        n = graph.getNumVertices();
+        lat.resize(n);
+        lon.resize(n);
+        for (int u = 0; u < n; u++) {
+            lat[u] = graph.getLat(u);
+            lon[u] = graph.getLongi(u);
+        }
+    }
+
+    int size() const { return n; }
+
+    Weight weight(int u, int v) const {
+        return toWeight<Weight>(Graph::haversine(lat[u], lon[u], lat[v], lon[v]));
+    }
+
+    template<typename F>
+    void forEachNeighbour(int u, F&& f) const {
+        for (int v = 0; v < n; v++) {
+            if (v != u) f(v, weight(u, v));
+        }
+    }
+
+    size_t memoryFootprint() const {
+        return (lat.capacity() + lon.capacity()) * sizeof(double);
+    }
+
+private:
+    int n = 0;
+    std::vector<double> lat;
+    std::vector<double> lon;
+};
+
+// grafo só de leitura especializado em tempo de compilação no armazenamento, no tipo de peso e na direção
+template<template<typename> class StoragePolicy, typename Weight, bool Directed>
+class StaticGraph {
+public:
+    using weight_type = Weight;
+    static constexpr bool directed = Directed;
+
+    StaticGraph() = default;
+
+    explicit StaticGraph(const Graph& graph) {
+        storage.build(graph, Directed);
+    }
+
+    int getNumVertices() const { return storage.size(); }
+
+    Weight weight(int u, int v) const { return storage.weight(u, v); }
+
+    template<typename F>
+    void forEachNeighbour(int u, F&& f) const { storage.forEachNeighbour(u, std::forward<F>(f)); }
+
+    const StoragePolicy<Weight>& getStorage() const { return storage; }
+
+    size_t memoryFootprint() const { return sizeof(*this) + storage.memoryFootprint(); }
+
+    std::string describe() const {
+        return std::string(StoragePolicy<Weight>::name) + "<" + weightName<Weight>() + ", "
+             + (Directed ? "directed" : "undirected") + ">";
+    }
+
+private:
+    StoragePolicy<Weight> storage;
+};
+
+// instanciações escolhidas pelo dispatcher
+using AnyStaticGraph = std::variant<
+    std::monostate,
+    StaticGraph<DenseStorage, double, false>,
+    StaticGraph<DenseStorage, double, true>,
+    StaticGraph<DenseStorage, float, false>,
+    StaticGraph<DenseStorage, int32_t, false>,
+    StaticGraph<DenseStorage, int32_t, true>,
+    StaticGraph<CsrStorage, double, false>,
+    StaticGraph<CsrStorage, double, true>,
+    StaticGraph<CsrStorage, int32_t, false>,
+    StaticGraph<CsrStorage, int32_t, true>,
+    StaticGraph<GeometricStorage, double, false>,
+    StaticGraph<GeometricStorage, float, false>
+>;
+
+// verdadeiro para os grafos com matriz densa, cujas linhas podem ser percorridas pelos kernels vetorizados
+template<typename G>
+struct isDenseGraph : std::false_type {};
+
+template<typename Weight, bool Directed>
+struct isDenseGraph<StaticGraph<DenseStorage, Weight, Directed>> : std::true_type {};
+
+// acima deste número de vértices as matrizes densas guardam float
+#define DENSE_FLOAT_VERTICES 2000
+// densidade (arestas / pares) a partir da qual se usa a matriz densa
+#define DENSE_MIN_DENSITY 0.5
+
+// escolhe a instanciação adequada a um grafo já carregado
+AnyStaticGraph makeStaticGraph(const Graph& graph);
+
+// chama f com a instanciação guardada; devolve false se ainda não houver nenhuma
+template<typename F>
+bool withStaticGraph(const AnyStaticGraph& any, F&& f) {
+    return std::visit([&](const auto& g) {
+        if constexpr (std::is_same<std::decay_t<decltype(g)>, std::monostate>::value) {
+            return false;
+        } else {
+            f(g);
+            return true;
+        }
+    }, any);
+}
+
+/// @brief Vizinho mais próximo sobre uma matriz densa: cada passo é um argmin vetorizado da linha do vértice atual,
+/// ignorando os vértices visitados. Dá o mesmo caminho que a versão genérica (empates pelo menor índice).
+/// Esta função tem complexidade O(V^2).
+template<typename G>
+std::vector<int> denseNearestNeighbourT(const G& g, int start_vertex) {
+    using Weight = typename G::weight_type;
+    int n = g.getNumVertices();
+    std::vector<int> path;
+    path.reserve(n);
+    std::vector<uint64_t> visited = makeBitmask(n);
+
+    int current_vertex = start_vertex;
+    path.push_back(current_vertex);
+    setBit(visited, current_vertex);
+
+    while ((int)path.size() < n) {
+        const Weight* row = g.getStorage().row(current_vertex);
+        int next_vertex = maskedArgmin(row, visited.data(), n);
+        if (next_vertex == -1 || row[next_vertex] == DenseStorage<Weight>::NO_EDGE) break;
+
+        path.push_back(next_vertex);
+        setBit(visited, next_vertex);
+        current_vertex = next_vertex;
+    }
+
+    return path;
+}
+
+/// @brief Vizinho mais próximo sobre um grafo especializado; a pesquisa só segue arestas do armazenamento.
+/// Esta função tem complexidade O(V + E) em CSR e O(V^2) em armazenamento denso ou geométrico.
+/// @param g Grafo especializado.
+/// @param start_vertex Vértice inicial.
+/// @return Caminho encontrado (pode ficar incompleto se um vértice não tiver vizinhos por visitar).
+template<typename G>
+std::vector<int> nearestNeighbourT(const G& g, int start_vertex) {
+    if constexpr (isDenseGraph<G>::value) return denseNearestNeighbourT(g, start_vertex);
+
+    using Weight = typename G::weight_type;
+    int n = g.getNumVertices();
+    std::vector<int> path;
+    std::vector<bool> visited(n, false);
+
+    int current_vertex = start_vertex;
+    path.push_back(current_vertex);
+    visited[current_vertex] = true;
+
+    while ((int)path.size() < n) {
+        int next_vertex = -1;
+        Weight min_distance = std::numeric_limits<Weight>::max();
+
+        g.forEachNeighbour(current_vertex, [&](int v, Weight w) {
+            if (!visited[v] && w < min_distance) {
+                next_vertex = v;
+                min_distance = w;
+            }
+        });
+
+        if (next_vertex == -1) break;
+
+        path.push_back(next_vertex);
+        visited[next_vertex] = true;
+        current_vertex = next_vertex;
+    }
+
+    return path;
+}
+
+/// @brief Prim denso sobre a matriz: em cada passo um argmin vetorizado das chaves escolhe o vértice a juntar e a
+/// sua linha relaxa as chaves dos restantes. Escolhe os mesmos vértices e pais que o Prim com fila de prioridade.
+/// Esta função tem complexidade O(V^2).
+/// @param g Grafo especializado com armazenamento denso.
+/// @param children Filhos de cada vértice na MST, preenchido pela função.
+template<typename G>
+void densePrimT(const G& g, std::vector<std::vector<int>>& children) {
+    using Weight = typename G::weight_type;
+    int n = g.getNumVertices();
+    std::vector<int> parent(n, -1);
+    std::vector<Weight> key(n, DenseStorage<Weight>::NO_EDGE);
+    std::vector<uint64_t> in_tree = makeBitmask(n);
+
+    key[0] = 0;
+    for (int added = 0; added < n; added++) {
+        int u = maskedArgmin(key.data(), in_tree.data(), n);
+        if (u == -1 || key[u] == DenseStorage<Weight>::NO_EDGE) break;
+        setBit(in_tree, u);
+        if (parent[u] != -1) children[parent[u]].push_back(u);
+        relaxKeys(g.getStorage().row(u), in_tree.data(), key.data(), parent.data(), u, n);
+    }
+}
+
+/// @brief MST de um grafo especializado pelo Prim a partir do vértice 0: densePrimT com matriz densa, senão Prim com
+/// fila de prioridade sobre os vizinhos do armazenamento (todos os pares, nos grafos só com coordenadas).
+/// Só lê o grafo, pelo que pode correr em paralelo com outros solvers.
+/// Esta função tem complexidade O(E log V), ou O(V^2) com matriz densa.
+/// @param g Grafo especializado.
+/// @return Pai de cada vértice na MST (-1 na raiz e nos vértices fora da árvore).
+template<typename G>
+std::vector<int> mstParentT(const G& g) {
+    using Weight = typename G::weight_type;
+    int n = g.getNumVertices();
+    std::vector<int> parent(n, -1);
+
+    if constexpr (isDenseGraph<G>::value) {
+        std::vector<std::vector<int>> children(n);
+        densePrimT(g, children);
+        for (int u = 0; u < n; u++) {
+            for (int v : children[u]) parent[v] = u;
+        }
+    } else {
+        std::vector<Weight> key(n, std::numeric_limits<Weight>::max());
+        std::vector<bool> in_tree(n, false);
+
+        std::priority_queue<std::pair<Weight, int>, std::vector<std::pair<Weight, int>>, std::greater<std::pair<Weight, int>>> pq;
+        if (n > 0) {
+            key[0] = 0;
+            pq.push(std::make_pair(Weight(0), 0));
+        }
+        while (!pq.empty()) {
+            int u = pq.top().second;
+            pq.pop();
+            if (in_tree[u]) continue;
+            in_tree[u] = true;
+
+            g.forEachNeighbour(u, [&](int v, Weight w) {
+                if (!in_tree[v] && w < key[v]) {
+                    key[v] = w;
+                    parent[v] = u;
+                    pq.push(std::make_pair(w, v));
+                }
+            });
+        }
+    }
+    return parent;
+}
+
+/// @brief Custo de um ciclo sobre um grafo especializado, com a mesma regra de Graph::calculateTotalDistance.
+/// @param g Grafo especializado.
+/// @param path Ciclo.
+/// @return Custo total, acumulado em double.
+template<typename G>
+double tourCostT(const G& g, const std::vector<int>& path) {
+    double total = 0.0;
+    for (size_t i = 0; i + 1 < path.size(); i++) {
+        total += g.weight(path[i], path[i + 1]);
+    }
+    if (!path.empty()) total += g.weight(path.back(), path[0]);
+    return total;
+}
+
+#endif //PROJETO2DA_STATIC_GRAPH_H
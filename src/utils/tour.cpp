@@ -0,0 +1,228 @@
+#include "tour.h"
+
+/// @brief Devolve o ciclo como vetor de cidades.
+/// Esta função tem complexidade O(n).
+/// @param start Cidade inicial.
+/// @return Vetor com as cidades pela ordem de next, a começar em start.
+std::vector<int> Tour::toVector(int start) const {
+    std::vector<int> order;
+    order.reserve(size());
+    int city = start;
+    for (int i = 0; i < size(); i++) {
+        order.push_back(city);
+        city = next(city);
+    }
+    return order;
+}
+
+/// @brief Constrói um ciclo em array.
+/// @param order Permutação das cidades 0..n-1.
+ArrayTour::ArrayTour(const std::vector<int>& order) : order(order), pos(order.size()) {
+    for (int i = 0; i < (int)order.size(); i++) {
+        pos[order[i]] = i;
+    }
+}
+
+int ArrayTour::size() const {
+    return order.size();
+}
+
+int ArrayTour::next(int city) const {
+    int i = pos[city] + 1;
+    return order[i == (int)order.size() ? 0 : i];
+}
+
+int ArrayTour::prev(int city) const {
+    int i = pos[city];
+    return order[i == 0 ? order.size() - 1 : i - 1];
+}
+
+bool ArrayTour::between(int a, int b, int c) const {
+    int pa = pos[a], pb = pos[b], pc = pos[c];
+    if (pa <= pc) return pa <= pb && pb <= pc;
+    return pb >= pa || pb <= pc;
+}
+
+/// @brief Inverte o caminho a..b, ou o complemento se este for mais curto.
+/// Esta função tem complexidade O(n).
+void ArrayTour::reverse(int a, int b) {
+    int n = order.size();
+    int i = pos[a], j = pos[b];
+    int len = (j - i + n) % n + 1;
+    if (2 * len > n) {
+        // the complement next(b)..prev(a) is shorter and gives the same cycle
+        int ni = (j + 1) % n;
+        j = (i - 1 + n) % n;
+        i = ni;
+        len = n - len;
+    }
+    for (int k = 0; k < len / 2; k++) {
+        int x = (i + k) % n, y = (j - k + n) % n;
+        std::swap(order[x], order[y]);
+        pos[order[x]] = x;
+        pos[order[y]] = y;
+    }
+}
+
+std::string ArrayTour::name() const {
+    return "array";
+}
+
+/// @brief Constrói um ciclo em lista de dois níveis, com segmentos de ~sqrt(n) cidades.
+/// @param order Permutação das cidades 0..n-1.
+TwoLevelTour::TwoLevelTour(const std::vector<int>& order) :
+    n(order.size()),
+    group_size(std::max(8, (int)std::sqrt((double)order.size()))),
+    segment_of(order.size()),
+    index_in(order.size()) {
+    rebuild(order);
+}
+
+int TwoLevelTour::size() const {
+    return n;
+}
+
+/// @brief Posição de uma cidade dentro do seu segmento, na orientação do ciclo.
+int TwoLevelTour::position(int city) const {
+    int s = segment_of[city];
+    return reversed[s] ? cities[s].size() - 1 - index_in[city] : index_in[city];
+}
+
+/// @brief Cidade numa posição (na orientação do ciclo) de um segmento.
+int TwoLevelTour::cityAt(int segment, int position) const {
+    const std::vector<int>& seg = cities[segment];
+    return reversed[segment] ? seg[seg.size() - 1 - position] : seg[position];
+}
+
+/// @brief Chave que ordena as cidades pela ordem do ciclo, a partir do primeiro segmento.
+long long TwoLevelTour::key(int city) const {
+    return (long long)rank[segment_of[city]] * n + position(city);
+}
+
+int TwoLevelTour::next(int city) const {
+    int s = segment_of[city];
+    int p = position(city);
+    if (p + 1 < (int)cities[s].size()) return cityAt(s, p + 1);
+    int r = rank[s] + 1;
+    return cityAt(segments[r == (int)segments.size() ? 0 : r], 0);
+}
+
+int TwoLevelTour::prev(int city) const {
+    int s = segment_of[city];
+    int p = position(city);
+    if (p > 0) return cityAt(s, p - 1);
+    int t = segments[rank[s] == 0 ? segments.size() - 1 : rank[s] - 1];
+    return cityAt(t, cities[t].size() - 1);
+}
+
+bool TwoLevelTour::between(int a, int b, int c) const {
+    long long ka = key(a), kb = key(b), kc = key(c);
+    if (ka <= kc) return ka <= kb && kb <= kc;
+    return kb >= ka || kb <= kc;
+}
+
+/// @brief Parte um segmento: as cidades a partir de uma posição passam para um novo segmento, logo a seguir no ciclo.
+/// Esta função tem complexidade O(sqrt(n)).
+/// @param segment Segmento a partir.
+/// @param position Posição (na orientação do ciclo) da primeira cidade do novo segmento, com 0 < position < tamanho.
+void TwoLevelTour::split(int segment, int position) {
+    std::vector<int>& seg = cities[segment];
+    int sz = seg.size();
+    int t = cities.size();
+
+    std::vector<int> moved;
+    if (!reversed[segment]) {
+        moved.assign(seg.begin() + position, seg.end());
+        seg.resize(position);
+    } else {
+        // in reversed segments the tail of the tour is the head of the vector
+        moved.assign(seg.begin(), seg.begin() + (sz - position));
+        seg.erase(seg.begin(), seg.begin() + (sz - position));
+        for (int i = 0; i < (int)seg.size(); i++) {
+            index_in[seg[i]] = i;
+        }
+    }
+    for (int i = 0; i < (int)moved.size(); i++) {
+        segment_of[moved[i]] = t;
+        index_in[moved[i]] = i;
+    }
+
+    char rev = reversed[segment];
+    cities.push_back(moved);
+    reversed.push_back(rev);
+    rank.push_back(0);
+
+    segments.insert(segments.begin() + rank[segment] + 1, t);
+    for (int r = rank[segment] + 1; r < (int)segments.size(); r++) {
+        rank[segments[r]] = r;
+    }
+}
+
+/// @brief Reconstrói os segmentos a partir de uma ordem das cidades, todos com group_size cidades e sem inversão.
+/// Esta função tem complexidade O(n).
+void TwoLevelTour::rebuild(const std::vector<int>& order) {
+    cities.clear();
+    reversed.clear();
+    rank.clear();
+    segments.clear();
+
+    for (int i = 0; i < n; i += group_size) {
+        int s = cities.size();
+        cities.emplace_back(order.begin() + i, order.begin() + std::min(n, i + group_size));
+        reversed.push_back(0);
+        rank.push_back(s);
+        segments.push_back(s);
+        for (int j = 0; j < (int)cities[s].size(); j++) {
+            segment_of[cities[s][j]] = s;
+            index_in[cities[s][j]] = j;
+        }
+    }
+}
+
+/// @brief Inverte o caminho a..b, ou o complemento se tiver menos segmentos.
+/// Os segmentos de a e de b são partidos para que o caminho seja uma sequência de segmentos inteiros, que é invertida
+/// trocando a ordem dos segmentos e o seu bit de inversão. Quando há demasiados segmentos a estrutura é reconstruída.
+/// Esta função tem complexidade O(sqrt(n)) amortizada.
+void TwoLevelTour::reverse(int a, int b) {
+    if (a == b || n < 3) return;
+
+    int p = position(a);
+    if (p > 0) split(segment_of[a], p);
+    p = position(b);
+    if (p < (int)cities[segment_of[b]].size() - 1) split(segment_of[b], p + 1);
+
+    int S = segments.size();
+    int first = rank[segment_of[a]];
+    int len = (rank[segment_of[b]] - first + S) % S + 1;
+    if (2 * len > S) {
+        first = (rank[segment_of[b]] + 1) % S;
+        len = S - len;
+    }
+
+    for (int i = 0; i < len / 2; i++) {
+        std::swap(segments[(first + i) % S], segments[(first + len - 1 - i) % S]);
+    }
+    for (int i = 0; i < len; i++) {
+        int r = (first + i) % S;
+        rank[segments[r]] = r;
+        reversed[segments[r]] ^= 1;
+    }
+
+    if (S > 2 * ((n + group_size - 1) / group_size) + 2) {
+        rebuild(toVector(cityAt(segments[0], 0)));
+    }
+}
+
+std::string TwoLevelTour::name() const {
+    return "two-level list";
+}
+
+/// @brief Cria a representação de ciclo adequada ao número de cidades.
+/// @param order Permutação das cidades 0..n-1.
+/// @return ArrayTour para ciclos pequenos, TwoLevelTour a partir de TWO_LEVEL_TOUR_THRESHOLD cidades.
+std::unique_ptr<Tour> makeTour(const std::vector<int>& order) {
+    if (order.size() >= TWO_LEVEL_TOUR_THRESHOLD) {
+        return std::unique_ptr<Tour>(new TwoLevelTour(order));
+    }
+    return std::unique_ptr<Tour>(new ArrayTour(order));
+}
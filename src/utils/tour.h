@@ -0,0 +1,145 @@
+#ifndef PROJETO2DA_TOUR_H
+#define PROJETO2DA_TOUR_H
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <queue>
+
+// a partir deste número de cidades makeTour usa a lista de dois níveis
+#define TWO_LEVEL_TOUR_THRESHOLD 1000
+
+// ciclo sobre as cidades 0..n-1, com as operações usadas pelas pesquisas locais
+class Tour {
+public:
+    virtual ~Tour() = default;
+
+    virtual int size() const = 0;
+
+    // cidade seguinte / anterior na orientação atual
+    virtual int next(int city) const = 0;
+    virtual int prev(int city) const = 0;
+
+    // true se, partindo de a no sentido de next, se encontra b antes (ou ao mesmo tempo) de c
+    virtual bool between(int a, int b, int c) const = 0;
+
+    // inverte o caminho a..b (no sentido de next); pode inverter o complemento, que dá o mesmo ciclo
+    virtual void reverse(int a, int b) = 0;
+
+    virtual std::string name() const = 0;
+
+    // ciclo como vetor, a começar em start
+    std::vector<int> toVector(int start) const;
+};
+
+// representação em array: next/prev/between em O(1), reverse em O(n)
+class ArrayTour : public Tour {
+public:
+    ArrayTour(const std::vector<int>& order);
+
+    int size() const override;
+    int next(int city) const override;
+    int prev(int city) const override;
+    bool between(int a, int b, int c) const override;
+    void reverse(int a, int b) override;
+    std::string name() const override;
+
+private:
+    std::vector<int> order;
+    std::vector<int> pos;
+};
+
+// lista duplamente ligada de dois níveis: segmentos de ~sqrt(n) cidades com bit de inversão;
+// next/prev/between em O(1), reverse em O(sqrt(n)) amortizado
+class TwoLevelTour : public Tour {
+public:
+    TwoLevelTour(const std::vector<int>& order);
+
+    int size() const override;
+    int next(int city) const override;
+    int prev(int city) const override;
+    bool between(int a, int b, int c) const override;
+    void reverse(int a, int b) override;
+    std::string name() const override;
+
+private:
+    int position(int city) const;
+    int cityAt(int segment, int position) const;
+    long long key(int city) const;
+
+    void split(int segment, int position);
+    void rebuild(const std::vector<int>& order);
+
+    int n;
+    int group_size;
+
+    std::vector<int> segment_of;
+    std::vector<int> index_in;
+
+    std::vector<std::vector<int>> cities;
+    std::vector<char> reversed;
+    std::vector<int> rank;
+    std::vector<int> segments; // segmentos por ordem no ciclo
+};
+
+// escolhe a representação adequada ao tamanho do ciclo
+std::unique_ptr<Tour> makeTour(const std::vector<int>& order);
+
+/// @brief Aplica movimentos 2-opt a um ciclo até não haver melhorias, usando listas de candidatos e don't-look bits.
+/// Esta função tem complexidade O(M * (k + custo de reverse)), onde M é o número de movimentos aplicados.
+/// @param tour Ciclo a melhorar.
+/// @param start Cidade por onde começa a fila de cidades a examinar (as restantes seguem a ordem do ciclo).
+/// @param candidates Candidatos de cada cidade, por distância crescente.
+/// @param cost Função cost(u, v) com a distância entre duas cidades.
+/// @param current Custo atual do ciclo; é atualizado a cada movimento.
+/// @param target_cost A pesquisa termina assim que o custo do ciclo for <= target_cost (0 para desativar).
+template<typename Cost>
+void twoOptMoves(Tour& tour, int start, const std::vector<std::vector<int>>& candidates, Cost&& cost,
+                 double& current, double target_cost) {
+    int n = tour.size();
+    std::vector<bool> active(n, true);
+    std::queue<int> queue;
+    for (int i = 0, city = start; i < n; i++, city = tour.next(city)) queue.push(city);
+
+    while (!queue.empty() && current > target_cost) {
+        int t1 = queue.front();
+        queue.pop();
+        active[t1] = false;
+
+        bool improved = false;
+        for (int dir = 0; dir < 2 && !improved; dir++) {
+            int t2 = dir == 0 ? tour.next(t1) : tour.prev(t1);
+            double d12 = cost(t1, t2);
+
+            for (int t3 : candidates[t1]) {
+                double d13 = cost(t1, t3);
+                if (d13 >= d12) break;
+
+                int t4 = dir == 0 ? tour.next(t3) : tour.prev(t3);
+                if (t3 == t2 || t4 == t1) continue;
+
+                double delta = d13 + cost(t2, t4) - d12 - cost(t3, t4);
+                if (delta < -1e-9) {
+                    // replace (t1,t2),(t3,t4) with (t1,t3),(t2,t4)
+                    if (dir == 0) tour.reverse(t2, t3);
+                    else tour.reverse(t1, t4);
+                    current += delta;
+
+                    for (int v : {t1, t2, t3, t4}) {
+                        if (!active[v]) {
+                            active[v] = true;
+                            queue.push(v);
+                        }
+                    }
+                    improved = true;
+                    break;
+                }
+            }
+        }
+    }
+
+}
+
+#endif //PROJETO2DA_TOUR_H
@@ -0,0 +1,46 @@
+#include "union_find.h"
+
+#include <utility>
+
+/// @brief Constrói n conjuntos singulares.
+/// @param n Número de elementos.
+UnionFind::UnionFind(int n) : parent(n), size(n, 1) {
+    for (int i = 0; i < n; i++) {
+        parent[i] = i;
+    }
+}
+
+/// @brief Encontra o representante do conjunto de um elemento.
+/// Esta função tem complexidade O(α(n)) amortizada.
+/// @param x Elemento.
+/// @return Representante do conjunto.
+int UnionFind::find(int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+/// @brief Junta os conjuntos de dois elementos.
+/// Esta função tem complexidade O(α(n)) amortizada.
+/// @return True se os conjuntos eram diferentes, false caso contrário.
+bool UnionFind::unite(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return false;
+    if (size[a] < size[b]) std::swap(a, b);
+    parent[b] = a;
+    size[a] += size[b];
+    return true;
+}
+
+/// @brief Verifica se dois elementos estão no mesmo conjunto.
+bool UnionFind::connected(int a, int b) {
+    return find(a) == find(b);
+}
+
+/// @brief Devolve o tamanho do conjunto de um elemento.
+int UnionFind::setSize(int x) {
+    return size[find(x)];
+}
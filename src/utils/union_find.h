@@ -0,0 +1,25 @@
+#ifndef PROJETO2DA_UNION_FIND_H
+#define PROJETO2DA_UNION_FIND_H
+
+#include <vector>
+
+// conjuntos disjuntos com compressão de caminho e união por tamanho
+class UnionFind {
+public:
+    UnionFind(int n);
+
+    int find(int x);
+
+    // junta os conjuntos de a e b; devolve false se já estavam juntos
+    bool unite(int a, int b);
+
+    bool connected(int a, int b);
+
+    int setSize(int x);
+
+private:
+    std::vector<int> parent;
+    std::vector<int> size;
+};
+
+#endif //PROJETO2DA_UNION_FIND_H